@@ -0,0 +1,334 @@
+#ifndef ALLOCATIONTELEMETRY_H
+#define ALLOCATIONTELEMETRY_H
+
+#include <iostream>       // For standard input/output operations (cout, cerr)
+#include <atomic>         // For single-writer counters readable by snapshot()
+#include <mutex>          // For the registry (thread registration and snapshots only)
+#include <vector>         // For the list of thread blocks
+#include <string>         // For source names and JSON output
+#include <sstream>        // For building the JSON document
+#include <cstdint>        // For fixed-width integer types
+#include <cstddef>        // For std::size_t
+
+#include "CpuFeatures.h"  // For countLeadingZeros64
+
+//------------------------------------------------------------------------------
+// Section 1: Why Not Just Print?
+//------------------------------------------------------------------------------
+
+/*
+ * The Problem:
+ * - SimpleAllocator used to write a formatted std::cout line with typeid(T).name() on every call.
+ *   Formatting costs microseconds, and std::cout takes a lock, so every allocating thread serializes
+ *   on the stream. Accounting like that can only ever be switched on while debugging.
+ *
+ * Low-Overhead Telemetry:
+ * - Every thread owns a private, cache-line-aligned block of counters, one set per telemetry source
+ *   (an allocator or subsystem registered by name). The hot path finds the block through a
+ *   thread_local pointer and bumps two counters in it: no I/O, no locks, no shared cache lines.
+ * - Counters are bucketed by size class: bucket b counts requests of [2^(b-1), 2^b) bytes
+ *   (bucket 0 is size 0), which doubles as a log2 size histogram.
+ * - Each counter has exactly one writer, so it is updated with a relaxed load + store (no lock-prefixed
+ *   read-modify-write); std::atomic only makes concurrent reads by snapshot() well defined.
+ * - snapshot() locks the registry, which the hot path never touches, and sums all thread blocks.
+ *   Counts of exited threads are folded into a retired total and their blocks are reused.
+ * - AllocationSnapshot can be merged with others and written as JSON.
+ */
+
+const std::size_t kTelemetrySizeClasses = 48;
+const std::size_t kMaxTelemetrySources = 8;
+
+// Bucket index: number of significant bits of `bytes` (0 for 0, 1 for 1, 2 for 2-3, 3 for 4-7, ...).
+std::size_t telemetrySizeClass(std::size_t bytes) {
+    if (bytes == 0) return 0;
+    const std::size_t bucket = 64 - static_cast<std::size_t>(countLeadingZeros64(bytes));
+    return bucket < kTelemetrySizeClasses ? bucket : kTelemetrySizeClasses - 1;
+}
+
+struct AllocationCounters {
+    std::uint64_t allocCalls[kTelemetrySizeClasses] = {};
+    std::uint64_t allocBytes[kTelemetrySizeClasses] = {};
+    std::uint64_t freeCalls[kTelemetrySizeClasses] = {};
+    std::uint64_t freeBytes[kTelemetrySizeClasses] = {};
+};
+
+//------------------------------------------------------------------------------
+// Section 2: Snapshots
+//------------------------------------------------------------------------------
+
+struct AllocationSnapshot {
+    struct Source {
+        std::string name;
+        AllocationCounters counters;
+
+        std::uint64_t totalAllocCalls() const { return sum(counters.allocCalls); }
+        std::uint64_t totalAllocBytes() const { return sum(counters.allocBytes); }
+        std::uint64_t totalFreeCalls() const { return sum(counters.freeCalls); }
+        std::uint64_t totalFreeBytes() const { return sum(counters.freeBytes); }
+        std::int64_t liveBytes() const {
+            return static_cast<std::int64_t>(totalAllocBytes()) - static_cast<std::int64_t>(totalFreeBytes());
+        }
+
+    private:
+        static std::uint64_t sum(const std::uint64_t (&values)[kTelemetrySizeClasses]) {
+            std::uint64_t total = 0;
+            for (std::uint64_t v : values) total += v;
+            return total;
+        }
+    };
+
+    std::vector<Source> sources;
+
+    /*
+     * Function: merge()
+     *
+     * Purpose: Add the counts of `other` (e.g. a snapshot from another process or run) source by source,
+     *          matching sources by name.
+     */
+    void merge(const AllocationSnapshot& other) {
+        for (const Source& theirs : other.sources) {
+            Source* mine = nullptr;
+            for (Source& s : sources) {
+                if (s.name == theirs.name) mine = &s;
+            }
+            if (mine == nullptr) {
+                sources.push_back(theirs);
+                continue;
+            }
+            for (std::size_t b = 0; b < kTelemetrySizeClasses; ++b) {
+                mine->counters.allocCalls[b] += theirs.counters.allocCalls[b];
+                mine->counters.allocBytes[b] += theirs.counters.allocBytes[b];
+                mine->counters.freeCalls[b] += theirs.counters.freeCalls[b];
+                mine->counters.freeBytes[b] += theirs.counters.freeBytes[b];
+            }
+        }
+    }
+
+    /*
+     * Function: toJson()
+     *
+     * Purpose: One object per source with totals and the non-empty size classes
+     *          ("le" = upper bound of the class in bytes).
+     */
+    std::string toJson() const {
+        std::ostringstream out;
+        out << "{\"sources\":[";
+        for (std::size_t i = 0; i < sources.size(); ++i) {
+            const Source& s = sources[i];
+            out << (i ? "," : "") << "{\"name\":\"" << s.name << "\""
+                << ",\"alloc_calls\":" << s.totalAllocCalls() << ",\"alloc_bytes\":" << s.totalAllocBytes()
+                << ",\"free_calls\":" << s.totalFreeCalls() << ",\"free_bytes\":" << s.totalFreeBytes()
+                << ",\"live_bytes\":" << s.liveBytes() << ",\"size_classes\":[";
+            bool first = true;
+            for (std::size_t b = 0; b < kTelemetrySizeClasses; ++b) {
+                if (s.counters.allocCalls[b] == 0 && s.counters.freeCalls[b] == 0) continue;
+                const std::uint64_t upper = b == 0 ? 0 : (std::uint64_t(1) << b) - 1;
+                out << (first ? "" : ",") << "{\"le\":" << upper
+                    << ",\"alloc_calls\":" << s.counters.allocCalls[b] << ",\"alloc_bytes\":" << s.counters.allocBytes[b]
+                    << ",\"free_calls\":" << s.counters.freeCalls[b] << ",\"free_bytes\":" << s.counters.freeBytes[b] << "}";
+                first = false;
+            }
+            out << "]}";
+        }
+        out << "]}";
+        return out.str();
+    }
+};
+
+//------------------------------------------------------------------------------
+// Section 3: Per-Thread Counter Blocks and the Registry
+//------------------------------------------------------------------------------
+
+class TelemetryRegistry {
+public:
+    struct alignas(64) SourceCounters {
+        std::atomic<std::uint64_t> allocCalls[kTelemetrySizeClasses];
+        std::atomic<std::uint64_t> allocBytes[kTelemetrySizeClasses];
+        std::atomic<std::uint64_t> freeCalls[kTelemetrySizeClasses];
+        std::atomic<std::uint64_t> freeBytes[kTelemetrySizeClasses];
+    };
+
+    struct ThreadBlock {
+        SourceCounters sources[kMaxTelemetrySources];
+    };
+
+    // Never destroyed: thread_local destructors may still retire blocks during program exit.
+    static TelemetryRegistry& instance() {
+        static TelemetryRegistry* registry = new TelemetryRegistry;
+        return *registry;
+    }
+
+    int registerSource(const char* name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::size_t i = 0; i < names_.size(); ++i) {
+            if (names_[i] == name) return static_cast<int>(i);
+        }
+        if (names_.size() == kMaxTelemetrySources) {
+            std::cerr << "Error: Too many telemetry sources; '" << name << "' is not recorded.\n";
+            return -1;
+        }
+        names_.emplace_back(name);
+        return static_cast<int>(names_.size() - 1);
+    }
+
+    // The calling thread's counters (registered on first use), or nullptr once the thread's Holder has
+    // been destroyed: another thread_local destructor may still allocate during thread exit, and the
+    // retired block may already belong to a different thread.
+    static ThreadBlock* threadBlock() {
+        if (threadExited()) {
+            return nullptr;
+        }
+        static thread_local Holder holder;
+        return holder.block;
+    }
+
+    // Events recorded after threadBlock() returned nullptr go straight into the retired totals.
+    void recordAfterExit(int source, std::size_t bucket, std::uint64_t bytes, bool deallocation) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        AllocationCounters& c = retired_[source];
+        if (deallocation) {
+            ++c.freeCalls[bucket];
+            c.freeBytes[bucket] += bytes;
+        } else {
+            ++c.allocCalls[bucket];
+            c.allocBytes[bucket] += bytes;
+        }
+    }
+
+    AllocationSnapshot snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        AllocationSnapshot result;
+        for (std::size_t s = 0; s < names_.size(); ++s) {
+            AllocationSnapshot::Source source;
+            source.name = names_[s];
+            source.counters = retired_[s];
+            for (const ThreadBlock* block : live_) {
+                add(source.counters, block->sources[s]);
+            }
+            result.sources.push_back(source);
+        }
+        return result;
+    }
+
+private:
+    struct Holder {
+        ThreadBlock* block;
+        Holder() : block(instance().acquire()) {}
+        ~Holder() {
+            threadExited() = true;
+            instance().retire(block);
+            block = nullptr;
+        }
+    };
+
+    // Trivially destructible, so it stays readable for the rest of thread exit.
+    static bool& threadExited() {
+        static thread_local bool exited = false;
+        return exited;
+    }
+
+    static void add(AllocationCounters& total, const SourceCounters& c) {
+        for (std::size_t b = 0; b < kTelemetrySizeClasses; ++b) {
+            total.allocCalls[b] += c.allocCalls[b].load(std::memory_order_relaxed);
+            total.allocBytes[b] += c.allocBytes[b].load(std::memory_order_relaxed);
+            total.freeCalls[b] += c.freeCalls[b].load(std::memory_order_relaxed);
+            total.freeBytes[b] += c.freeBytes[b].load(std::memory_order_relaxed);
+        }
+    }
+
+    ThreadBlock* acquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ThreadBlock* block;
+        if (!free_.empty()) {
+            block = free_.back();
+            free_.pop_back();
+        } else {
+            block = new ThreadBlock;
+        }
+        for (SourceCounters& c : block->sources) {
+            for (std::size_t b = 0; b < kTelemetrySizeClasses; ++b) {
+                c.allocCalls[b].store(0, std::memory_order_relaxed);
+                c.allocBytes[b].store(0, std::memory_order_relaxed);
+                c.freeCalls[b].store(0, std::memory_order_relaxed);
+                c.freeBytes[b].store(0, std::memory_order_relaxed);
+            }
+        }
+        live_.push_back(block);
+        return block;
+    }
+
+    void retire(ThreadBlock* block) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::size_t s = 0; s < kMaxTelemetrySources; ++s) {
+            add(retired_[s], block->sources[s]);
+        }
+        for (std::size_t i = 0; i < live_.size(); ++i) {
+            if (live_[i] == block) {
+                live_[i] = live_.back();
+                live_.pop_back();
+                break;
+            }
+        }
+        free_.push_back(block);
+    }
+
+    TelemetryRegistry() = default;
+
+    mutable std::mutex mutex_;
+    std::vector<std::string> names_;
+    std::vector<ThreadBlock*> live_;
+    std::vector<ThreadBlock*> free_;
+    AllocationCounters retired_[kMaxTelemetrySources];
+};
+
+/*
+ * Class: AllocationTelemetry
+ *
+ * Description: Handle for one named source. Construct once (e.g. as a function-local static) and call
+ *              recordAllocation()/recordDeallocation() from any thread.
+ */
+class AllocationTelemetry {
+public:
+    explicit AllocationTelemetry(const char* name) : source_(TelemetryRegistry::instance().registerSource(name)) {}
+
+    void recordAllocation(std::size_t bytes) const {
+        if (source_ < 0) return;
+        const std::size_t bucket = telemetrySizeClass(bytes);
+        TelemetryRegistry::ThreadBlock* block = TelemetryRegistry::threadBlock();
+        if (block == nullptr) {
+            TelemetryRegistry::instance().recordAfterExit(source_, bucket, bytes, false);
+            return;
+        }
+        TelemetryRegistry::SourceCounters& c = block->sources[source_];
+        bump(c.allocCalls[bucket], 1);
+        bump(c.allocBytes[bucket], bytes);
+    }
+
+    void recordDeallocation(std::size_t bytes) const {
+        if (source_ < 0) return;
+        const std::size_t bucket = telemetrySizeClass(bytes);
+        TelemetryRegistry::ThreadBlock* block = TelemetryRegistry::threadBlock();
+        if (block == nullptr) {
+            TelemetryRegistry::instance().recordAfterExit(source_, bucket, bytes, true);
+            return;
+        }
+        TelemetryRegistry::SourceCounters& c = block->sources[source_];
+        bump(c.freeCalls[bucket], 1);
+        bump(c.freeBytes[bucket], bytes);
+    }
+
+private:
+    // Single writer: a relaxed load + store is enough and avoids a locked read-modify-write.
+    static void bump(std::atomic<std::uint64_t>& counter, std::uint64_t delta) {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    int source_;
+};
+
+// Snapshot of every source, merged across all threads that have ever recorded.
+AllocationSnapshot allocationTelemetrySnapshot() {
+    return TelemetryRegistry::instance().snapshot();
+}
+
+#endif // ALLOCATIONTELEMETRY_H
@@ -0,0 +1,319 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <iostream>        // For standard input/output operations (cout)
+#include <memory_resource> // For std::pmr::memory_resource and the pmr containers
+#include <vector>          // For std::pmr::vector
+#include <deque>           // For std::pmr::deque
+#include <list>            // For std::pmr::list
+#include <set>             // For std::pmr::set
+#include <map>             // For std::pmr::map
+#include <unordered_set>   // For std::pmr::unordered_set
+#include <string>          // For std::pmr::string
+#include <functional>      // For std::greater
+#include <cstddef>         // For std::size_t, std::max_align_t
+#include <cstdint>         // For std::uintptr_t
+#include <chrono>          // For timing the benchmark
+#include <algorithm>       // For std::max/std::min
+#include <utility>         // For std::swap
+
+//------------------------------------------------------------------------------
+// Section 1: Monotonic Arenas
+//------------------------------------------------------------------------------
+
+/*
+ * Why an arena?
+ * - runSTLContainers() builds a handful of containers, prints them and throws them away. Every node,
+ *   string and vector growth step is a separate malloc, and every one of them is freed individually.
+ * - An arena (bump allocator) hands out memory by advancing a pointer through a large chunk and frees
+ *   everything at once by resetting the pointer: allocation costs a few instructions and deallocation
+ *   is free.
+ *
+ * std::pmr integration:
+ * - Arena derives from std::pmr::memory_resource, so any std::pmr container (std::pmr::vector,
+ *   std::pmr::map, std::pmr::string, ...) can allocate from it through a std::pmr::polymorphic_allocator.
+ * - pmr containers pass their allocator down to their elements, so a std::pmr::list<std::pmr::string>
+ *   puts both the nodes and the string buffers in the arena.
+ *
+ * Features:
+ * - Stack-buffer seeding: the arena starts in a caller-provided buffer and only asks the upstream
+ *   resource for chunks once the buffer is exhausted.
+ * - Upstream chain: chunks come from any memory_resource (the global heap by default, another arena,
+ *   or std::pmr::null_memory_resource() to forbid growth beyond the seed buffer). Chunk sizes double
+ *   up to kArenaMaxChunkBytes.
+ * - Scopes and rewind: mark() records the current position and rewind() returns to it, releasing
+ *   chunks obtained since (keeping one spare for reuse). ArenaScope does this in its destructor, so scopes can nest. Objects
+ *   allocated inside a scope must be destroyed before the scope ends.
+ * - deallocate() is a no-op except for the most recent allocation, which is popped (LIFO), so a
+ *   vector growing at the top of the arena reuses its old space.
+ */
+
+const std::size_t kArenaInitialChunkBytes = 4 * 1024;
+const std::size_t kArenaMaxChunkBytes = 1024 * 1024;
+
+class Arena : public std::pmr::memory_resource {
+public:
+    struct Marker {
+        void* chunk;
+        char* cursor;
+    };
+
+    explicit Arena(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream) {}
+
+    // Seed the arena with `buffer` (typically a local array); it is used before any upstream chunk.
+    Arena(void* buffer, std::size_t bytes, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream),
+          seedBegin_(static_cast<char*>(buffer)),
+          seedEnd_(static_cast<char*>(buffer) + bytes),
+          cursor_(seedBegin_),
+          end_(seedEnd_) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() override {
+        release();
+        if (spare_ != nullptr) {
+            upstream_->deallocate(spare_, spare_->size, alignof(std::max_align_t));
+        }
+    }
+
+    Marker mark() const { return Marker{head_, cursor_}; }
+
+    /*
+     * Function: rewind()
+     *
+     * Purpose: Return to a position obtained from mark(). Chunks obtained after it go back upstream,
+     *          except the largest one, which is kept as a spare so that a scope opened and closed in a
+     *          loop does not call the upstream resource every iteration.
+     */
+    void rewind(const Marker& marker) {
+        while (head_ != marker.chunk) {
+            Chunk* chunk = head_;
+            head_ = chunk->prev;
+            reserved_ -= chunk->size;
+            if (spare_ == nullptr || spare_->size < chunk->size) {
+                std::swap(spare_, chunk);
+            }
+            if (chunk != nullptr) {
+                upstream_->deallocate(chunk, chunk->size, alignof(std::max_align_t));
+            }
+        }
+        cursor_ = marker.cursor;
+        lastAllocation_ = nullptr;
+        end_ = head_ != nullptr ? reinterpret_cast<char*>(head_) + head_->size : seedEnd_;
+        nextChunkBytes_ = head_ != nullptr ? std::min(head_->size * 2, kArenaMaxChunkBytes) : kArenaInitialChunkBytes;
+    }
+
+    // Free everything: back to the start of the seed buffer (or empty).
+    void release() { rewind(Marker{nullptr, seedBegin_}); }
+
+    // Bytes of upstream chunks currently in use (the spare chunk is not counted).
+    std::size_t bytesReservedUpstream() const { return reserved_; }
+    std::pmr::memory_resource* upstream() const { return upstream_; }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        char* p = alignUp(cursor_, alignment);
+        if (p == nullptr || p + bytes > end_ || p + bytes < p) {
+            addChunk(bytes, alignment);
+            p = alignUp(cursor_, alignment);
+        }
+        lastAllocation_ = p;
+        cursor_ = p + bytes;
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t) override {
+        if (p == lastAllocation_ && static_cast<char*>(p) + bytes == cursor_) {
+            cursor_ = static_cast<char*>(p); // Pop the most recent allocation
+            lastAllocation_ = nullptr;
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    struct Chunk {
+        Chunk* prev;
+        std::size_t size;
+    };
+
+    static char* alignUp(char* p, std::size_t alignment) {
+        if (p == nullptr) return nullptr;
+        const std::uintptr_t v = reinterpret_cast<std::uintptr_t>(p);
+        return reinterpret_cast<char*>((v + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1));
+    }
+
+    void addChunk(std::size_t bytes, std::size_t alignment) {
+        const std::size_t header = (sizeof(Chunk) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        std::size_t size = std::max(nextChunkBytes_, header + bytes + alignment);
+        Chunk* chunk;
+        if (spare_ != nullptr && spare_->size >= size) {
+            chunk = spare_;
+            size = spare_->size;
+            spare_ = nullptr;
+        } else {
+            chunk = static_cast<Chunk*>(upstream_->allocate(size, alignof(std::max_align_t)));
+        }
+        chunk->prev = head_;
+        chunk->size = size;
+        head_ = chunk;
+        reserved_ += size;
+        cursor_ = reinterpret_cast<char*>(chunk) + header;
+        end_ = reinterpret_cast<char*>(chunk) + size;
+        nextChunkBytes_ = std::min(nextChunkBytes_ * 2, kArenaMaxChunkBytes);
+    }
+
+    std::pmr::memory_resource* upstream_;
+    char* seedBegin_ = nullptr;
+    char* seedEnd_ = nullptr;
+    char* cursor_ = nullptr;
+    char* end_ = nullptr;
+    Chunk* head_ = nullptr;       // Most recent upstream chunk (chunks form a stack)
+    Chunk* spare_ = nullptr;      // Largest chunk released by rewind(), reused by addChunk()
+    void* lastAllocation_ = nullptr;
+    std::size_t nextChunkBytes_ = kArenaInitialChunkBytes;
+    std::size_t reserved_ = 0;
+};
+
+/*
+ * Class: ArenaScope
+ *
+ * Description: Marks an arena on construction and rewinds it on destruction.
+ */
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena& arena) : arena_(arena), marker_(arena.mark()) {}
+    ~ArenaScope() { arena_.rewind(marker_); }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    Arena& arena_;
+    Arena::Marker marker_;
+};
+
+//------------------------------------------------------------------------------
+// Section 2: The STLContainers Examples on an Arena
+//------------------------------------------------------------------------------
+
+/*
+ * Function: buildContainerExamples()
+ *
+ * Purpose: The containers from runSTLContainers(), as pmr containers drawing from `resource`.
+ *          Returns a checksum so the benchmark's work cannot be optimized away; prints when `print` is set.
+ */
+std::size_t buildContainerExamples(std::pmr::memory_resource* resource, bool print) {
+    std::pmr::vector<int> vec({1, 2, 3, 4, 5}, resource);
+    std::pmr::deque<double> deq({1.1, 2.2, 3.3}, resource);
+    deq.push_front(0.1);
+    deq.push_back(4.4);
+
+    std::pmr::list<std::pmr::string> lst(resource);
+    for (const char* s : {"Alpha", "Beta", "Gamma", "Omega (a string too long for the small-string buffer)"}) {
+        lst.emplace_back(s);
+    }
+
+    std::pmr::set<int, std::greater<int>> myset({5, 2, 5, 3, 2, 1}, resource);
+
+    std::pmr::map<std::pmr::string, int> mymap(resource);
+    mymap["one"] = 1;
+    mymap["two"] = 2;
+    mymap["three"] = 3;
+
+    std::pmr::unordered_set<int> uset({10, 20, 30, 40}, 0, std::hash<int>(), std::equal_to<int>(), resource);
+    uset.insert(50);
+
+    if (print) {
+        std::cout << "Vector elements: ";
+        for (int v : vec) { std::cout << v << " "; }
+        std::cout << "\nDeque elements: ";
+        for (double d : deq) { std::cout << d << " "; }
+        std::cout << "\nList elements: ";
+        for (const auto& s : lst) { std::cout << s << " | "; }
+        std::cout << "\nSet elements in descending order: ";
+        for (int s : myset) { std::cout << s << " "; }
+        std::cout << "\nMap elements: ";
+        for (const auto& pair : mymap) { std::cout << pair.first << ": " << pair.second << "  "; }
+        std::cout << "\nUnordered set size: " << uset.size() << "\n";
+    }
+    return vec.size() + deq.size() + lst.back().size() + myset.size() + mymap.size() + uset.size();
+}
+
+/*
+ * Function: benchmarkArena()
+ *
+ * Purpose: Builds and destroys the example containers `iterations` times with the default heap resource,
+ *          a heap-backed arena rewound per iteration, and a stack-seeded arena.
+ */
+void benchmarkArena(std::size_t iterations) {
+    using Clock = std::chrono::steady_clock;
+    auto time = [&](auto&& body) {
+        std::size_t checksum = 0;
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            checksum += body();
+        }
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+        return std::make_pair(ns, checksum);
+    };
+
+    const auto heap = time([] { return buildContainerExamples(std::pmr::new_delete_resource(), false); });
+
+    Arena arena;
+    const auto arenaResult = time([&] {
+        ArenaScope scope(arena);
+        return buildContainerExamples(&arena, false);
+    });
+
+    alignas(std::max_align_t) char buffer[8192];
+    Arena stackArena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    const auto stackResult = time([&] {
+        ArenaScope scope(stackArena);
+        return buildContainerExamples(&stackArena, false);
+    });
+
+    std::cout << "Build + destroy the example containers (" << iterations << " iterations):\n"
+              << "  new/delete resource: " << heap.first << " ns\n"
+              << "  Arena (heap chunks): " << arenaResult.first << " ns (" << heap.first / arenaResult.first << "x)\n"
+              << "  Arena (stack seed):  " << stackResult.first << " ns (" << heap.first / stackResult.first << "x)"
+              << (heap.second == arenaResult.second && heap.second == stackResult.second ? "" : "  CHECKSUM MISMATCH")
+              << "\n";
+}
+
+//------------------------------------------------------------------------------
+// Section 3: Demonstration
+//------------------------------------------------------------------------------
+
+void runArenaExamples() {
+    std::cout << "\n--- Monotonic Arena (std::pmr::memory_resource) ---\n";
+
+    // The STLContainers examples, allocated from a 4 KiB stack buffer with the heap as fallback.
+    alignas(std::max_align_t) char buffer[4096];
+    Arena arena(buffer, sizeof(buffer));
+    buildContainerExamples(&arena, true);
+    std::cout << "Bytes requested from the heap: " << arena.bytesReservedUpstream() << "\n";
+
+    // Nested scopes: inner allocations disappear when the inner scope ends.
+    Arena scoped;
+    {
+        ArenaScope outer(scoped);
+        std::pmr::vector<int> kept({1, 2, 3}, &scoped);
+        {
+            ArenaScope inner(scoped);
+            std::pmr::vector<int> temporary(100000, 7, &scoped);
+            std::cout << "Inside inner scope: " << scoped.bytesReservedUpstream() << " bytes reserved\n";
+        }
+        std::cout << "After inner scope:  " << scoped.bytesReservedUpstream() << " bytes reserved, kept = "
+                  << kept[0] << kept[1] << kept[2] << "\n";
+    }
+
+    benchmarkArena(100000);
+}
+
+#endif // ARENA_H
@@ -0,0 +1,532 @@
+#ifndef ASYNCREADENGINE_H
+#define ASYNCREADENGINE_H
+
+#include <iostream>       // For standard input/output operations (cout, cerr)
+#include <fstream>        // For creating the demo file
+#include <vector>         // For request batches and buffers
+#include <deque>          // For the fallback pool's job queue
+#include <future>         // For std::promise/std::future completion handles
+#include <thread>         // For the completion thread and the fallback workers
+#include <mutex>          // For queue-depth accounting and submission
+#include <condition_variable> // For blocking when the queue depth is reached
+#include <atomic>         // For the completion thread's stop flag
+#include <cstdint>        // For fixed-width integer types
+#include <cstring>        // For memset
+#include <cstdio>         // For std::remove (cleanup of demo files)
+#include <cerrno>         // For errno values reported as negative results
+#include <chrono>         // For timing the benchmark
+#include <random>         // For random read offsets
+#include <algorithm>      // For std::min/std::max
+
+#include <fcntl.h>        // For open()
+#include <unistd.h>       // For pread(), close()
+#include <sys/uio.h>      // For struct iovec
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h> // For the io_uring ABI structures and constants
+#include <sys/mman.h>       // For mapping the submission/completion rings
+#include <sys/syscall.h>    // For the io_uring system call numbers
+#include <sys/eventfd.h>    // For the completion thread's wakeup descriptor
+#endif
+#endif
+
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register) && \
+    defined(IORING_OFF_SQES)
+#define ASYNCREAD_HAS_IO_URING 1
+#else
+#define ASYNCREAD_HAS_IO_URING 0
+#endif
+
+#include "ByteStreaming.h" // For MyData (the demo reads record files)
+
+//------------------------------------------------------------------------------
+// Section 1: Asynchronous Reads (Keeping the Device Queue Full)
+//------------------------------------------------------------------------------
+
+/*
+ * The Problem:
+ * - Every read in ByteStreaming.h is a blocking ifstream call: the thread issues one request, waits for
+ *   the device, then issues the next. An NVMe drive needs dozens of outstanding requests to reach its
+ *   rated random-read IOPS; at queue depth 1 it sits mostly idle.
+ *
+ * Class: AsyncFileReader
+ * - read(buffer, length, offset) returns immediately with a std::future<long> that later yields the
+ *   number of bytes read (or -errno). readBatch() submits many requests with one system call.
+ * - At most `queueDepth` requests are outstanding; further submissions block until one completes.
+ *
+ * Backends:
+ * - io_uring (Linux 5.1+): requests are written into a submission ring shared with the kernel and
+ *   submitted in bulk with io_uring_enter(); a completion thread reaps the completion ring and fulfils
+ *   the futures. It sleeps on an eventfd registered with the ring, which the kernel signals for every
+ *   completion and the destructor can signal directly. The rings are driven through the raw system calls, so no liburing dependency is needed.
+ * - pread thread pool: if io_uring is unavailable (old kernel, disabled by seccomp/containers, non-Linux),
+ *   a pool of worker threads performs blocking pread() calls, so the device still sees up to
+ *   `fallbackThreads` concurrent requests.
+ */
+
+struct AsyncReadOptions {
+    unsigned queueDepth = 64;      // Maximum outstanding requests
+    bool preferIoUring = true;     // Use io_uring when the kernel allows it
+    unsigned fallbackThreads = 0;  // pread workers for the fallback (0: min(queueDepth, 4 * cores))
+};
+
+struct ReadRequest {
+    void* buffer;
+    std::size_t length;
+    std::uint64_t offset;
+};
+
+class AsyncFileReader {
+public:
+    explicit AsyncFileReader(const char* path, AsyncReadOptions options = AsyncReadOptions())
+        : queueDepth_(std::max(1u, options.queueDepth)) {
+        fd_ = ::open(path, O_RDONLY);
+        if (fd_ < 0) {
+            return;
+        }
+        if (!options.preferIoUring || !startIoUring()) {
+            unsigned threads = options.fallbackThreads;
+            if (threads == 0) {
+                threads = std::min(queueDepth_, std::max(1u, 4 * std::thread::hardware_concurrency()));
+            }
+            startThreadPool(threads);
+        }
+    }
+
+    ~AsyncFileReader() {
+        if (fd_ < 0) {
+            return;
+        }
+        {
+            // Let every outstanding request complete before tearing the backend down.
+            std::unique_lock<std::mutex> lock(mutex_);
+            slotFreed_.wait(lock, [this] { return inFlight_ == 0; });
+            stopping_ = true;
+        }
+#if ASYNCREAD_HAS_IO_URING
+        if (ringFd_ >= 0) {
+            // A NOP with a null tag wakes the completion thread for shutdown. If the ring refuses it,
+            // wake the thread through its eventfd instead so the join cannot hang.
+            if (!submitIoUring(nullptr)) {
+                reaperStop_.store(true, std::memory_order_release);
+                const std::uint64_t one = 1;
+                ssize_t n;
+                do {
+                    n = ::write(eventFd_, &one, sizeof(one));
+                } while (n < 0 && errno == EINTR);
+            }
+            completionThread_.join();
+            stopIoUring();
+        }
+#endif
+        jobReady_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+        ::close(fd_);
+    }
+
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+    bool isOpen() const { return fd_ >= 0; }
+    explicit operator bool() const { return fd_ >= 0; }
+    bool usingIoUring() const { return ringFd_ >= 0; }
+    const char* backendName() const { return ringFd_ >= 0 ? "io_uring" : "pread thread pool"; }
+    unsigned queueDepth() const { return queueDepth_; }
+
+    /*
+     * Function: read()
+     *
+     * Purpose: Queue a read of `length` bytes at `offset` into `buffer` (which must stay valid until the
+     *          future is ready). Blocks only while `queueDepth` requests are already outstanding.
+     * Returns: a future yielding bytes read (0 at end of file) or -errno.
+     */
+    std::future<long> read(void* buffer, std::size_t length, std::uint64_t offset) {
+        ReadRequest request = {buffer, length, offset};
+        return std::move(readBatch(&request, 1).front());
+    }
+
+    // Queue `count` reads; with io_uring they are submitted with as few system calls as the depth allows.
+    std::vector<std::future<long>> readBatch(const ReadRequest* requests, std::size_t count) {
+        std::vector<std::future<long>> futures;
+        futures.reserve(count);
+        std::vector<Pending*> batch;
+        for (std::size_t i = 0; i < count; ++i) {
+            Pending* pending = new Pending();
+            pending->iov.iov_base = requests[i].buffer;
+            pending->iov.iov_len = requests[i].length;
+            pending->offset = requests[i].offset;
+            futures.push_back(pending->promise.get_future());
+            if (fd_ < 0) {
+                pending->promise.set_value(-EBADF);
+                delete pending;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (inFlight_ >= queueDepth_ && !batch.empty()) {
+                lock.unlock();
+                dispatch(batch); // Submit what we have before waiting for a free slot
+                batch.clear();
+                lock.lock();
+            }
+            slotFreed_.wait(lock, [this] { return inFlight_ < queueDepth_; });
+            ++inFlight_;
+            lock.unlock();
+            batch.push_back(pending);
+        }
+        if (!batch.empty()) {
+            dispatch(batch);
+        }
+        return futures;
+    }
+
+private:
+    struct Pending {
+        std::promise<long> promise;
+        struct iovec iov;
+        std::uint64_t offset = 0;
+    };
+
+    void complete(Pending* pending, long result) {
+        pending->promise.set_value(result);
+        delete pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --inFlight_;
+        }
+        slotFreed_.notify_all();
+    }
+
+    void dispatch(const std::vector<Pending*>& batch) {
+#if ASYNCREAD_HAS_IO_URING
+        if (ringFd_ >= 0) {
+            std::lock_guard<std::mutex> lock(submitMutex_);
+            for (Pending* pending : batch) {
+                queueSqe(pending);
+            }
+            enterIoUring(static_cast<unsigned>(batch.size()));
+            return;
+        }
+#endif
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.insert(jobs_.end(), batch.begin(), batch.end());
+        }
+        jobReady_.notify_all();
+    }
+
+    //--------------------------------------------------------------------------
+    // pread thread-pool backend
+    //--------------------------------------------------------------------------
+
+    void startThreadPool(unsigned threads) {
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] {
+                while (true) {
+                    Pending* pending;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        jobReady_.wait(lock, [this] { return !jobs_.empty() || stopping_; });
+                        if (jobs_.empty()) {
+                            return;
+                        }
+                        pending = jobs_.front();
+                        jobs_.pop_front();
+                    }
+                    ssize_t n;
+                    do {
+                        n = ::pread(fd_, pending->iov.iov_base, pending->iov.iov_len, static_cast<off_t>(pending->offset));
+                    } while (n < 0 && errno == EINTR);
+                    complete(pending, n < 0 ? -errno : static_cast<long>(n));
+                }
+            });
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // io_uring backend
+    //--------------------------------------------------------------------------
+
+#if ASYNCREAD_HAS_IO_URING
+    bool startIoUring() {
+        struct io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        const int ringFd = static_cast<int>(::syscall(__NR_io_uring_setup, queueDepth_, &params));
+        if (ringFd < 0) {
+            return false; // ENOSYS / EPERM (e.g. blocked in containers): use the thread pool
+        }
+
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        const bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap) {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+        sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+        cqRing_ = singleMmap ? sqRing_
+                             : ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+        const int eventFd = ::eventfd(0, EFD_CLOEXEC);
+        if (sqRing_ == MAP_FAILED || cqRing_ == MAP_FAILED || sqes == MAP_FAILED || eventFd < 0 ||
+            ::syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_EVENTFD, &eventFd, 1) < 0) {
+            if (sqRing_ != MAP_FAILED) ::munmap(sqRing_, sqRingSize_);
+            if (!singleMmap && cqRing_ != MAP_FAILED) ::munmap(cqRing_, cqRingSize_);
+            if (sqes != MAP_FAILED) ::munmap(sqes, sqesSize_);
+            sqRing_ = cqRing_ = nullptr;
+            if (eventFd >= 0) ::close(eventFd);
+            ::close(ringFd);
+            return false;
+        }
+
+        unsigned char* sq = static_cast<unsigned char*>(sqRing_);
+        unsigned char* cq = static_cast<unsigned char*>(cqRing_);
+        sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+        singleMmap_ = singleMmap;
+        ringFd_ = ringFd;
+        eventFd_ = eventFd;
+
+        completionThread_ = std::thread(&AsyncFileReader::reapCompletions, this);
+        return true;
+    }
+
+    void stopIoUring() {
+        ::munmap(sqes_, sqesSize_);
+        ::munmap(sqRing_, sqRingSize_);
+        if (!singleMmap_) ::munmap(cqRing_, cqRingSize_);
+        ::close(ringFd_);
+        ::close(eventFd_);
+        ringFd_ = -1;
+        eventFd_ = -1;
+    }
+
+    // Fill the next submission queue entry. Called with submitMutex_ held.
+    void queueSqe(Pending* pending) {
+        const unsigned tail = *sqTail_; // Only this process writes the tail
+        const unsigned index = tail & sqMask_;
+        struct io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        if (pending != nullptr) {
+            sqe->opcode = IORING_OP_READV;
+            sqe->fd = fd_;
+            sqe->addr = reinterpret_cast<std::uint64_t>(&pending->iov);
+            sqe->len = 1;
+            sqe->off = pending->offset;
+        } else {
+            sqe->opcode = IORING_OP_NOP;
+        }
+        sqe->user_data = reinterpret_cast<std::uint64_t>(pending);
+        sqArray_[index] = index;
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE); // Publish the entry to the kernel
+    }
+
+    // Submit the `toSubmit` newest entries. Returns false if they had to be withdrawn.
+    // Called with submitMutex_ held.
+    bool enterIoUring(unsigned toSubmit) {
+        while (toSubmit > 0) {
+            const long submitted = ::syscall(__NR_io_uring_enter, ringFd_, toSubmit, 0, 0, nullptr, 0);
+            if (submitted >= 0) {
+                toSubmit -= static_cast<unsigned>(submitted);
+                continue;
+            }
+            const int error = errno;
+            if (error == EINTR) {
+                continue;
+            }
+            if (error == EAGAIN || error == EBUSY) {
+                // Out of kernel resources or the completion queue is backed up: let the completion
+                // thread reap some requests before trying again instead of spinning on the syscall.
+                std::unique_lock<std::mutex> lock(mutex_);
+                const unsigned before = inFlight_;
+                slotFreed_.wait_for(lock, std::chrono::milliseconds(1), [&] { return inFlight_ < before; });
+                continue;
+            }
+            failUnsubmitted(error);
+            return false;
+        }
+        return true;
+    }
+
+    // Hard submission error: withdraw the entries the kernel has not consumed and complete them with
+    // -error, so their futures become ready and inFlight_ still drains. Called with submitMutex_ held.
+    void failUnsubmitted(int error) {
+        const unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        const unsigned tail = *sqTail_;
+        __atomic_store_n(sqTail_, head, __ATOMIC_RELEASE);
+        for (unsigned i = head; i != tail; ++i) {
+            Pending* pending = reinterpret_cast<Pending*>(sqes_[sqArray_[i & sqMask_]].user_data);
+            if (pending != nullptr) {
+                complete(pending, -error);
+            }
+        }
+    }
+
+    bool submitIoUring(Pending* pending) {
+        std::lock_guard<std::mutex> lock(submitMutex_);
+        queueSqe(pending);
+        return enterIoUring(1);
+    }
+
+    // Completion thread: wait for CQEs and fulfil the matching futures. The eventfd counts completions
+    // posted since the last read, so one that lands while the ring is being drained is not missed.
+    void reapCompletions() {
+        while (true) {
+            std::uint64_t signalled;
+            while (::read(eventFd_, &signalled, sizeof(signalled)) < 0 && errno == EINTR) {
+            }
+            unsigned head = *cqHead_;
+            const unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+            bool shutdown = false;
+            for (; head != tail; ++head) {
+                const struct io_uring_cqe& cqe = cqes_[head & cqMask_];
+                Pending* pending = reinterpret_cast<Pending*>(cqe.user_data);
+                if (pending == nullptr) {
+                    shutdown = true;
+                } else {
+                    complete(pending, cqe.res);
+                }
+            }
+            __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+            if (shutdown || reaperStop_.load(std::memory_order_acquire)) {
+                return;
+            }
+        }
+    }
+#else
+    bool startIoUring() { return false; }
+#endif
+
+    int fd_ = -1;
+    unsigned queueDepth_;
+
+    std::mutex mutex_;
+    std::condition_variable slotFreed_;
+    std::condition_variable jobReady_;
+    unsigned inFlight_ = 0;
+    bool stopping_ = false;
+
+    // Thread-pool backend
+    std::deque<Pending*> jobs_;
+    std::vector<std::thread> workers_;
+
+    // io_uring backend
+    int ringFd_ = -1;
+#if ASYNCREAD_HAS_IO_URING
+    std::mutex submitMutex_;
+    std::thread completionThread_;
+    int eventFd_ = -1;                    // Registered with the ring; wakes the completion thread
+    std::atomic<bool> reaperStop_{false}; // Shutdown without a NOP (the ring refused it)
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    std::size_t sqRingSize_ = 0;
+    std::size_t cqRingSize_ = 0;
+    std::size_t sqesSize_ = 0;
+    bool singleMmap_ = false;
+    unsigned* sqHead_ = nullptr;
+    unsigned* sqTail_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned* sqArray_ = nullptr;
+    struct io_uring_sqe* sqes_ = nullptr;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    struct io_uring_cqe* cqes_ = nullptr;
+#endif
+};
+
+//------------------------------------------------------------------------------
+// Section 2: Demonstration - Random Reads at Increasing Queue Depth
+//------------------------------------------------------------------------------
+
+/*
+ * Function: runAsyncReadEngineExamples()
+ *
+ * Purpose: Creates a record file, then performs the same set of random 4 KiB reads with blocking pread()
+ *          and with AsyncFileReader at several queue depths. On a warm page cache the numbers mostly show
+ *          per-request overhead; on a cold NVMe-backed file, higher depths overlap device latency.
+ */
+void runAsyncReadEngineExamples() {
+    using Clock = std::chrono::steady_clock;
+    std::cout << "\n--- Asynchronous Reads (io_uring / pread pool) ---\n";
+
+    const char* filename = "records_async.bin";
+    const std::size_t recordCount = 4u << 20; // 64 MiB of MyData
+    {
+        std::vector<MyData> records;
+        records.reserve(recordCount);
+        for (std::size_t i = 0; i < recordCount; ++i) {
+            records.emplace_back(static_cast<int>(i), i * 0.5);
+        }
+        std::ofstream ofs(filename, std::ios::binary);
+        ofs.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(MyData)));
+    }
+
+    const std::size_t blockSize = 4096;
+    const std::size_t blocks = recordCount * sizeof(MyData) / blockSize;
+    const std::size_t readCount = 20000;
+    std::mt19937_64 gen(7);
+    std::vector<std::uint64_t> offsets(readCount);
+    for (std::uint64_t& offset : offsets) {
+        offset = (gen() % blocks) * blockSize;
+    }
+
+    // Blocking baseline
+    std::vector<unsigned char> buffer(blockSize);
+    long long checksum = 0;
+    const int fd = ::open(filename, O_RDONLY);
+    auto start = Clock::now();
+    for (std::uint64_t offset : offsets) {
+        if (::pread(fd, buffer.data(), blockSize, static_cast<off_t>(offset)) == static_cast<ssize_t>(blockSize)) {
+            checksum += reinterpret_cast<const MyData*>(buffer.data())->id;
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    ::close(fd);
+    std::cout << "Blocking pread:        " << readCount / seconds / 1000.0 << " K reads/s (checksum " << checksum << ")\n";
+
+    for (unsigned depth : {1u, 8u, 32u, 64u}) {
+        AsyncReadOptions options;
+        options.queueDepth = depth;
+        AsyncFileReader reader(filename, options);
+        if (!reader) {
+            std::cerr << "Error: Cannot open file '" << filename << "' for async reads.\n";
+            break;
+        }
+
+        std::vector<unsigned char> buffers(depth * blockSize);
+        std::vector<ReadRequest> requests(depth);
+        long long asyncChecksum = 0;
+        start = Clock::now();
+        for (std::size_t done = 0; done < readCount; done += depth) {
+            const std::size_t n = std::min<std::size_t>(depth, readCount - done);
+            for (std::size_t i = 0; i < n; ++i) {
+                requests[i] = ReadRequest{buffers.data() + i * blockSize, blockSize, offsets[done + i]};
+            }
+            std::vector<std::future<long>> results = reader.readBatch(requests.data(), n);
+            for (std::size_t i = 0; i < n; ++i) {
+                if (results[i].get() == static_cast<long>(blockSize)) {
+                    asyncChecksum += reinterpret_cast<const MyData*>(buffers.data() + i * blockSize)->id;
+                }
+            }
+        }
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::cout << "Async QD " << depth << (depth < 10 ? "  " : " ") << "(" << reader.backendName() << "): "
+                  << readCount / seconds / 1000.0 << " K reads/s"
+                  << (asyncChecksum == checksum ? "" : " (MISMATCH)") << "\n";
+    }
+
+    std::remove(filename);
+}
+
+#endif // ASYNCREADENGINE_H
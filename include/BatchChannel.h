@@ -0,0 +1,350 @@
+#ifndef BATCHCHANNEL_H
+#define BATCHCHANNEL_H
+
+#include <iostream>       // For standard input/output operations (cout)
+#include <atomic>         // For depth, close flag and counters
+#include <thread>         // For std::this_thread::yield and the benchmark threads
+#include <vector>         // For batch buffers and the benchmark threads
+#include <algorithm>      // For std::min
+#include <climits>        // For INT_MAX
+#include <cstdint>        // For std::uint64_t
+#include <cstddef>        // For std::size_t
+#include <chrono>         // For wait-time accounting and the benchmark
+#include "CpuFeatures.h"  // For cpuRelax
+#include "MpmcQueue.h"    // For the storage ring and FutexEvent
+
+//------------------------------------------------------------------------------
+// Section 1: BatchChannel<T> - Batched Producer/Consumer With Backpressure
+//------------------------------------------------------------------------------
+
+/*
+ * Why batch?
+ * - A queue that wakes its consumer once per item pays a context switch per item as soon as the consumer
+ *   runs out of work. Draining everything that has accumulated (up to a limit) on each wakeup, and
+ *   notifying once per pushed batch, divides that cost by the batch size.
+ * - Bounded memory: depth_ counts items reserved by producers but not yet taken by consumers. A producer
+ *   must reserve room below the high-water mark before it writes, so the channel never holds more than
+ *   highWaterMark() items. push_batch() waits for room; try_push_batch() fails fast and reports how many
+ *   items it accepted, leaving the caller to drop, retry or shed load.
+ * - Close semantics: close() refuses new items and wakes everybody. Consumers still receive every item
+ *   accepted before (or concurrently with) close(); pop_batch() returns 0 only once the channel is closed
+ *   and empty, so no sentinel value is needed to stop a consumer.
+ * - The items themselves travel through an MpmcQueue sized to the high-water mark; because producers
+ *   reserve first, its pushes never fail for lack of room.
+ */
+struct BatchChannelStats {
+    std::size_t depth = 0;             // Items currently buffered (or reserved by a producer)
+    std::size_t peakDepth = 0;         // Highest depth observed
+    std::uint64_t pushed = 0;          // Items accepted
+    std::uint64_t popped = 0;          // Items delivered
+    std::uint64_t rejected = 0;        // Items refused by try_push_batch() at the high-water mark
+    std::uint64_t pushBatches = 0;     // Successful push_batch()/try_push_batch() calls
+    std::uint64_t popBatches = 0;      // Non-empty pop_batch() returns
+    std::uint64_t producerParks = 0;   // Producer futex sleeps (high-water mark reached)
+    std::uint64_t consumerParks = 0;   // Consumer futex sleeps (channel empty)
+    std::uint64_t producerWaitNs = 0;  // Time producers spent waiting for room
+    std::uint64_t consumerWaitNs = 0;  // Time consumers spent waiting for items
+};
+
+template <typename T>
+class BatchChannel {
+public:
+    explicit BatchChannel(std::size_t highWaterMark)
+        : highWater_(highWaterMark < 1 ? 1 : highWaterMark), items_(highWater_) {}
+
+    BatchChannel(const BatchChannel&) = delete;
+    BatchChannel& operator=(const BatchChannel&) = delete;
+
+    // Pushes all `count` items, waiting at the high-water mark; returns fewer only if the channel closes.
+    std::size_t push_batch(const T* items, std::size_t count) {
+        std::size_t done = 0;
+        while (done < count) {
+            const std::size_t n = reserve(count - done, true);
+            if (n == 0) {
+                break; // Closed
+            }
+            publish(items + done, n);
+            done += n;
+        }
+        if (done > 0) {
+            bump(pushBatches_, 1);
+        }
+        return done;
+    }
+
+    // Pushes as many items as fit below the high-water mark without waiting; the rest are rejected.
+    std::size_t try_push_batch(const T* items, std::size_t count) {
+        const std::size_t n = reserve(count, false);
+        if (n > 0) {
+            publish(items, n);
+            bump(pushBatches_, 1);
+        }
+        if (n < count && !closed()) {
+            bump(rejected_, count - n);
+        }
+        return n;
+    }
+
+    bool push(const T& item) { return push_batch(&item, 1) == 1; }
+
+    // Waits for at least one item, then takes up to `maxCount`; 0 once the channel is closed and drained.
+    std::size_t pop_batch(T* out, std::size_t maxCount) {
+        if (maxCount == 0) {
+            return 0;
+        }
+        std::chrono::steady_clock::time_point waitStart;
+        for (int round = 0;; ++round) {
+            const std::size_t n = items_.try_pop_n(out, maxCount);
+            if (n > 0) {
+                if (round > 0) {
+                    addWait(consumerWaitNs_, waitStart);
+                }
+                release(n);
+                // Left items behind: hand the rest to another sleeping consumer.
+                if (n == maxCount && items_.size() > 0) {
+                    itemsReady_.notify();
+                }
+                return n;
+            }
+            if (drained()) {
+                return 0;
+            }
+            if (round == 0) {
+                waitStart = std::chrono::steady_clock::now();
+            }
+            if (round < kMpmcSpinRounds) {
+                cpuRelax();
+            } else if (round < kMpmcSpinRounds + kMpmcYieldRounds) {
+                std::this_thread::yield();
+            } else {
+                const std::uint32_t ticket = itemsReady_.prepareWait();
+                if (items_.size() > 0 || drained()) {
+                    itemsReady_.cancelWait();
+                    continue;
+                }
+                bump(consumerParks_, 1);
+                itemsReady_.wait(ticket);
+            }
+        }
+    }
+
+    bool pop(T& out) { return pop_batch(&out, 1) == 1; }
+
+    void close() {
+        closed_.store(true, std::memory_order_seq_cst);
+        itemsReady_.notifyAll();
+        roomFree_.notifyAll();
+    }
+
+    bool closed() const { return closed_.load(std::memory_order_seq_cst); }
+    std::size_t highWaterMark() const { return highWater_; }
+    std::size_t depth() const { return depth_.load(std::memory_order_relaxed); }
+
+    BatchChannelStats stats() const {
+        BatchChannelStats s;
+        s.depth = depth_.load(std::memory_order_relaxed);
+        s.peakDepth = peakDepth_.load(std::memory_order_relaxed);
+        s.pushed = pushed_.load(std::memory_order_relaxed);
+        s.popped = popped_.load(std::memory_order_relaxed);
+        s.rejected = rejected_.load(std::memory_order_relaxed);
+        s.pushBatches = pushBatches_.load(std::memory_order_relaxed);
+        s.popBatches = popBatches_.load(std::memory_order_relaxed);
+        s.producerParks = producerParks_.load(std::memory_order_relaxed);
+        s.consumerParks = consumerParks_.load(std::memory_order_relaxed);
+        s.producerWaitNs = producerWaitNs_.load(std::memory_order_relaxed);
+        s.consumerWaitNs = consumerWaitNs_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    // Counters are shared by all producers or all consumers, so they need a real read-modify-write.
+    template <typename Counter>
+    static void bump(Counter& counter, std::uint64_t amount) {
+        counter.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    void addWait(std::atomic<std::uint64_t>& counter, std::chrono::steady_clock::time_point start) {
+        bump(counter, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // Claims room for up to `want` items below the high-water mark; 0 if closed (or full and !block).
+    std::size_t reserve(std::size_t want, bool block) {
+        std::chrono::steady_clock::time_point waitStart;
+        bool waited = false;
+        std::size_t depth = depth_.load(std::memory_order_seq_cst);
+        for (int round = 0;; ++round) {
+            if (closed()) {
+                break;
+            }
+            if (depth < highWater_) {
+                const std::size_t take = std::min(want, highWater_ - depth);
+                if (depth_.compare_exchange_weak(depth, depth + take, std::memory_order_seq_cst)) {
+                    std::size_t peak = peakDepth_.load(std::memory_order_relaxed);
+                    while (peak < depth + take &&
+                           !peakDepth_.compare_exchange_weak(peak, depth + take, std::memory_order_relaxed)) {
+                    }
+                    if (waited) {
+                        addWait(producerWaitNs_, waitStart);
+                    }
+                    return take;
+                }
+                continue; // depth was reloaded by the failed CAS
+            }
+            if (!block) {
+                return 0;
+            }
+            if (!waited) {
+                waited = true;
+                waitStart = std::chrono::steady_clock::now();
+            }
+            if (round < kMpmcSpinRounds) {
+                cpuRelax();
+            } else if (round < kMpmcSpinRounds + kMpmcYieldRounds) {
+                std::this_thread::yield();
+            } else {
+                const std::uint32_t ticket = roomFree_.prepareWait();
+                if (depth_.load(std::memory_order_seq_cst) < highWater_ || closed()) {
+                    roomFree_.cancelWait();
+                } else {
+                    bump(producerParks_, 1);
+                    roomFree_.wait(ticket);
+                }
+            }
+            depth = depth_.load(std::memory_order_seq_cst);
+        }
+        if (waited) {
+            addWait(producerWaitNs_, waitStart);
+        }
+        return 0;
+    }
+
+    // Writes reserved items; one consumer wakeup per batch.
+    void publish(const T* items, std::size_t n) {
+        std::size_t done = 0;
+        while (done < n) {
+            done += items_.try_push_n(items + done, n - done); // Room is reserved, so this only spins if a
+            if (done < n) {                                    // consumer has claimed but not yet freed a cell
+                cpuRelax();
+            }
+        }
+        bump(pushed_, n);
+        itemsReady_.notify();
+    }
+
+    void release(std::size_t n) {
+        bump(popped_, n);
+        bump(popBatches_, 1);
+        const std::size_t before = depth_.fetch_sub(n, std::memory_order_seq_cst);
+        roomFree_.notify(static_cast<int>(std::min<std::size_t>(n, INT_MAX)));
+        if (before == n && closed()) {
+            itemsReady_.notifyAll(); // Last item after close(): release consumers still waiting for it
+        }
+    }
+
+    // Closed and nothing buffered or reserved by an in-flight producer.
+    bool drained() const { return closed() && depth_.load(std::memory_order_seq_cst) == 0; }
+
+    const std::size_t highWater_;
+    MpmcQueue<T> items_;
+    alignas(64) std::atomic<std::size_t> depth_{0};
+    std::atomic<bool> closed_{false};
+    FutexEvent itemsReady_;
+    FutexEvent roomFree_;
+    alignas(64) std::atomic<std::size_t> peakDepth_{0};
+    std::atomic<std::uint64_t> pushed_{0};
+    std::atomic<std::uint64_t> popped_{0};
+    std::atomic<std::uint64_t> rejected_{0};
+    std::atomic<std::uint64_t> pushBatches_{0};
+    std::atomic<std::uint64_t> popBatches_{0};
+    std::atomic<std::uint64_t> producerParks_{0};
+    std::atomic<std::uint64_t> consumerParks_{0};
+    std::atomic<std::uint64_t> producerWaitNs_{0};
+    std::atomic<std::uint64_t> consumerWaitNs_{0};
+};
+
+//------------------------------------------------------------------------------
+// Section 2: Benchmark - Item-at-a-Time vs. Batched
+//------------------------------------------------------------------------------
+
+void printBatchChannelStats(const BatchChannelStats& s) {
+    std::cout << "depth " << s.depth << " (peak " << s.peakDepth << "), pushed " << s.pushed << ", popped " << s.popped
+              << ", rejected " << s.rejected << "\n"
+              << "    items per pop " << (s.popBatches ? double(s.popped) / s.popBatches : 0.0)
+              << ", consumer parks " << s.consumerParks << " (wait " << s.consumerWaitNs / 1000000 << " ms)"
+              << ", producer parks " << s.producerParks << " (wait " << s.producerWaitNs / 1000000 << " ms)\n";
+}
+
+/*
+ * Function: benchmarkBatchChannel()
+ *
+ * Purpose: `producers` threads push `items` integers in batches of `batch`, `consumers` threads drain
+ *          up to `batch` per wakeup until the channel is closed. Prints items/s and the channel counters;
+ *          batch == 1 is the item-at-a-time baseline.
+ */
+void benchmarkBatchChannel(unsigned producers, unsigned consumers, std::size_t items, std::size_t batch,
+                           std::size_t highWater) {
+    BatchChannel<std::uint64_t> channel(highWater);
+    std::atomic<std::uint64_t> checksum{0};
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            std::vector<std::uint64_t> buffer(batch);
+            std::uint64_t sum = 0;
+            while (std::size_t n = channel.pop_batch(buffer.data(), batch)) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    sum += buffer[i];
+                }
+            }
+            checksum.fetch_add(sum, std::memory_order_relaxed);
+        });
+    }
+    std::vector<std::thread> producerThreads;
+    for (unsigned p = 0; p < producers; ++p) {
+        producerThreads.emplace_back([&, p] {
+            std::vector<std::uint64_t> buffer;
+            buffer.reserve(batch);
+            for (std::size_t i = p; i < items; i += producers) {
+                buffer.push_back(i);
+                if (buffer.size() == batch) {
+                    channel.push_batch(buffer.data(), buffer.size());
+                    buffer.clear();
+                }
+            }
+            channel.push_batch(buffer.data(), buffer.size());
+        });
+    }
+    for (std::thread& t : producerThreads) t.join();
+    channel.close();
+    for (std::thread& t : threads) t.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const BatchChannelStats s = channel.stats();
+    const bool complete = s.popped == items && checksum.load() == std::uint64_t(items) * (items - 1) / 2;
+    std::cout << "  batch " << batch << ": " << (complete ? items / seconds / 1e6 : 0.0) << " M items/s, "
+              << double(s.consumerParks + s.producerParks) / items << " parks per item\n    ";
+    printBatchChannelStats(s);
+}
+
+//------------------------------------------------------------------------------
+// Section 3: Demonstration
+//------------------------------------------------------------------------------
+
+void runBatchChannelExamples() {
+    std::cout << "\n--- Batching Channel With Backpressure ---\n";
+    BatchChannel<int> channel(4);
+    const int burst[] = {1, 2, 3, 4, 5, 6};
+    std::cout << "try_push_batch(6 items), high-water mark 4: accepted " << channel.try_push_batch(burst, 6) << "\n";
+    channel.close();
+    int out[8];
+    const std::size_t n = channel.pop_batch(out, 8);
+    std::cout << "After close(): push " << (channel.push(7) ? "accepted" : "rejected") << ", one pop_batch drained "
+              << n << ", next pop_batch returns " << channel.pop_batch(out, 8) << "\n  ";
+    printBatchChannelStats(channel.stats());
+
+    const std::size_t items = 1 << 20;
+    std::cout << "2 producers, 2 consumers, " << items << " items, high-water mark 1024:\n";
+    benchmarkBatchChannel(2, 2, items, 1, 1024);
+    benchmarkBatchChannel(2, 2, items, 64, 1024);
+}
+
+#endif // BATCHCHANNEL_H
@@ -0,0 +1,644 @@
+#ifndef BINARYSERIALIZATION_H
+#define BINARYSERIALIZATION_H
+
+#include <iostream>       // For standard input/output operations (cout, cerr)
+#include <fstream>        // For the file streams used by the round-trip demo and the benchmark
+#include <vector>         // For batch buffers and deserialized record containers
+#include <cstdint>        // For fixed-width integer types used by the wire layout
+#include <cstring>        // For memcpy/memcmp when moving bytes in and out of the wire buffers
+#include <cstdio>         // For std::remove (cleanup of benchmark files)
+#include <chrono>         // For timing the serialization benchmark
+#include <algorithm>      // For std::min when sizing batches
+
+#include "ByteStreaming.h" // For MyData, the record type persisted by this module
+#include "VarintCodec.h"   // For the zigzag + Stream VByte id encoding option
+#include "BlockCompression.h" // For optional per-batch block compression
+
+//------------------------------------------------------------------------------
+// Section 1: Why Raw memcpy Persistence Is Not a File Format
+//------------------------------------------------------------------------------
+
+/*
+ * Writing a MyData with `write(reinterpret_cast<const char*>(&data), sizeof(data))` stores `sizeof(MyData)`
+ * raw bytes per object. That has three problems:
+ *   - Padding: `int id` is followed by 4 bytes of padding before `double value`, so 16 bytes are written
+ *     for 12 bytes of information, and the padding bytes are uninitialized garbage.
+ *   - Portability: the bytes depend on the compiler's layout and the machine's endianness.
+ *   - Throughput: one write() call per object means per-call overhead dominates for millions of records.
+ *
+ * This module defines an explicit wire layout instead:
+ *
+ *   File header (16 bytes):
+ *     offset 0   char[4]   magic "CCBS"
+ *     offset 4   uint16    format version (kRecordStreamVersion)
+ *     offset 6   uint16    flags (encoding options, see below; unknown bits are rejected)
+ *     offset 8   uint64    number of records that follow
+ *
+ *   Record (12 bytes, no padding), RecordEncoding::Fixed:
+ *     offset 0   int32     id
+ *     offset 4   float64   value (IEEE-754 bit pattern)
+ *
+ *   Batch, RecordEncoding::VarintIds (flag kRecordFlagVarintIds), n = records in the batch:
+ *     uint32               byte length L of the id section
+ *     L bytes              Stream VByte of zigzag(id[i] - id[i-1]) (id[-1] = last id of the previous batch, or 0)
+ *     n * float64          values
+ *
+ *   Paged records (flag kRecordFlagPagedRecords, RecordEncoding::Fixed only):
+ *     zero padding from offset 16 to offset kRecordPageBytes (4096), then pages of kRecordsPerPage (341)
+ *     records, each padded with zeros to kRecordPageBytes, so every page is one aligned 4 KiB disk block
+ *     (RecordIndex.h reads them one at a time). The last page is padded too.
+ *
+ *   Compressed batch (flag kRecordFlagCompressed), wrapping either encoding above:
+ *     uint32               raw length R of the encoded batch
+ *     uint32               stored length C (C == R: stored uncompressed because compression did not help)
+ *     C bytes              BlockCompression.h block of the encoded batch
+ *
+ * All integers are little-endian regardless of the host. Records are encoded into a batch buffer
+ * and handed to the stream in one write() per batch, so the number of calls scales with
+ * records / kSerializationBatchRecords rather than with the number of records.
+ */
+
+const char kRecordStreamMagic[4] = {'C', 'C', 'B', 'S'};
+const std::uint16_t kRecordStreamVersion = 1;
+const std::size_t kRecordStreamHeaderSize = 16;
+const std::size_t kWireRecordSize = 12;
+const std::size_t kSerializationBatchRecords = 8192; // ~96 KiB of wire data per write() call
+const std::size_t kRecordPageBytes = 4096;
+const std::size_t kRecordsPerPage = kRecordPageBytes / kWireRecordSize; // 341, then 4 bytes of padding
+
+enum class RecordEncoding {
+    Fixed,     // 12 bytes per record
+    VarintIds  // Delta + zigzag + Stream VByte ids, raw values (see VarintCodec.h)
+};
+
+const std::uint16_t kRecordFlagVarintIds = 0x0001;
+const std::uint16_t kRecordFlagIndexFooter = 0x0002; // Records are followed by an index (RecordIndex.h)
+const std::uint16_t kRecordFlagCompressed = 0x0004;  // Each batch is block-compressed
+const std::uint16_t kRecordFlagPagedRecords = 0x0008; // Fixed records in padded, 4 KiB-aligned pages
+const std::uint16_t kKnownRecordFlags =
+    kRecordFlagVarintIds | kRecordFlagIndexFooter | kRecordFlagCompressed | kRecordFlagPagedRecords;
+
+struct RecordStreamHeader {
+    std::uint16_t version = kRecordStreamVersion;
+    std::uint16_t flags = 0;
+    std::uint64_t recordCount = 0;
+};
+
+//------------------------------------------------------------------------------
+// Section 2: Little-Endian Encoding Helpers
+//------------------------------------------------------------------------------
+
+/*
+ * Function: storeLittleEndian() / loadLittleEndian()
+ *
+ * Purpose: Write or read an unsigned integer byte by byte, least significant byte first.
+ *          The shifts make the result independent of host endianness; on little-endian machines
+ *          compilers turn these loops into a single unaligned load or store.
+ */
+template <typename UInt>
+void storeLittleEndian(unsigned char* dst, UInt v) {
+    for (std::size_t i = 0; i < sizeof(UInt); ++i) {
+        dst[i] = static_cast<unsigned char>(v >> (8 * i));
+    }
+}
+
+template <typename UInt>
+UInt loadLittleEndian(const unsigned char* src) {
+    UInt v = 0;
+    for (std::size_t i = 0; i < sizeof(UInt); ++i) {
+        v |= static_cast<UInt>(src[i]) << (8 * i);
+    }
+    return v;
+}
+
+// Encode one record into exactly kWireRecordSize bytes at `dst`.
+void encodeRecord(const MyData& record, unsigned char* dst) {
+    std::uint64_t valueBits;
+    std::memcpy(&valueBits, &record.value, sizeof(valueBits)); // Reinterpret the double's bits safely
+    storeLittleEndian<std::uint32_t>(dst, static_cast<std::uint32_t>(record.id));
+    storeLittleEndian<std::uint64_t>(dst + 4, valueBits);
+}
+
+// Decode one record from kWireRecordSize bytes at `src`.
+MyData decodeRecord(const unsigned char* src) {
+    const std::uint64_t valueBits = loadLittleEndian<std::uint64_t>(src + 4);
+    double value;
+    std::memcpy(&value, &valueBits, sizeof(value));
+    return MyData(static_cast<std::int32_t>(loadLittleEndian<std::uint32_t>(src)), value);
+}
+
+//------------------------------------------------------------------------------
+// Section 3: Stream Header
+//------------------------------------------------------------------------------
+
+void encodeRecordStreamHeader(const RecordStreamHeader& header, unsigned char* bytes) {
+    std::memcpy(bytes, kRecordStreamMagic, sizeof(kRecordStreamMagic));
+    storeLittleEndian<std::uint16_t>(bytes + 4, header.version);
+    storeLittleEndian<std::uint16_t>(bytes + 6, header.flags);
+    storeLittleEndian<std::uint64_t>(bytes + 8, header.recordCount);
+}
+
+bool writeRecordStreamHeader(std::ostream& out, const RecordStreamHeader& header) {
+    unsigned char bytes[kRecordStreamHeaderSize];
+    encodeRecordStreamHeader(header, bytes);
+    out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+    return static_cast<bool>(out);
+}
+
+/*
+ * Function: readRecordStreamHeader()
+ *
+ * Purpose: Read and validate the 16-byte header. Fails on a short read, a wrong magic number,
+ *          a version newer than this reader understands, or flags this version does not define.
+ */
+bool readRecordStreamHeader(std::istream& in, RecordStreamHeader& header) {
+    unsigned char bytes[kRecordStreamHeaderSize];
+    if (!in.read(reinterpret_cast<char*>(bytes), sizeof(bytes))) {
+        return false;
+    }
+    if (std::memcmp(bytes, kRecordStreamMagic, sizeof(kRecordStreamMagic)) != 0) {
+        return false;
+    }
+    header.version = loadLittleEndian<std::uint16_t>(bytes + 4);
+    header.flags = loadLittleEndian<std::uint16_t>(bytes + 6);
+    header.recordCount = loadLittleEndian<std::uint64_t>(bytes + 8);
+    return header.version == kRecordStreamVersion && (header.flags & ~kKnownRecordFlags) == 0;
+}
+
+//------------------------------------------------------------------------------
+// Section 4: Bulk serialize() / deserialize()
+//------------------------------------------------------------------------------
+
+/*
+ * Function: appendEncodedBatch()
+ *
+ * Purpose: Append `n` records in the given encoding to `out`. `prevId` carries the last id across
+ *          batches for the delta-encoded variant and is updated.
+ */
+void appendEncodedBatch(const MyData* records, std::size_t n, RecordEncoding encoding,
+                        std::uint32_t& prevId, std::vector<unsigned char>& out) {
+    const std::size_t start = out.size();
+    if (encoding == RecordEncoding::Fixed) {
+        out.resize(start + n * kWireRecordSize);
+        for (std::size_t i = 0; i < n; ++i) {
+            encodeRecord(records[i], out.data() + start + i * kWireRecordSize);
+        }
+        return;
+    }
+
+    std::vector<std::uint32_t> deltas(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::uint32_t id = static_cast<std::uint32_t>(records[i].id);
+        deltas[i] = zigzagEncode32(static_cast<std::int32_t>(id - prevId));
+        prevId = id;
+    }
+    out.resize(start + 4 + streamVByteMaxBytes(n) + n * 8);
+    const std::size_t idBytes = streamVByteEncode(deltas.data(), n, out.data() + start + 4);
+    storeLittleEndian<std::uint32_t>(out.data() + start, static_cast<std::uint32_t>(idBytes));
+    unsigned char* values = out.data() + start + 4 + idBytes;
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &records[i].value, sizeof(bits));
+        storeLittleEndian<std::uint64_t>(values + i * 8, bits);
+    }
+    out.resize(start + 4 + idBytes + n * 8);
+}
+
+/*
+ * Function: compressBatch()
+ *
+ * Purpose: Replace the encoded batch in `batch` with its compressed-batch framing (see Section 1),
+ *          using `scratch` as the compression buffer.
+ */
+void compressBatch(BlockCompressor& compressor, std::vector<unsigned char>& batch, std::vector<unsigned char>& scratch) {
+    scratch.resize(8 + blockCompressBound(batch.size()));
+    std::size_t stored = compressor.compress(batch.data(), batch.size(), scratch.data() + 8);
+    if (stored >= batch.size()) {
+        stored = batch.size();
+        std::memcpy(scratch.data() + 8, batch.data(), stored);
+    }
+    storeLittleEndian<std::uint32_t>(scratch.data(), static_cast<std::uint32_t>(batch.size()));
+    storeLittleEndian<std::uint32_t>(scratch.data() + 4, static_cast<std::uint32_t>(stored));
+    scratch.resize(8 + stored);
+    batch.swap(scratch);
+}
+
+/*
+ * Function: serializeTo()
+ *
+ * Purpose: The encoder behind every serialize() overload. Emits the header and then each encoded (and
+ *          optionally compressed) batch through `sink(const unsigned char* data, std::size_t size)`,
+ *          which returns false to abort. Records are encoded into a reusable batch buffer, so the sink
+ *          sees one call per batch.
+ * Returns: false as soon as the sink fails.
+ */
+template <typename Sink>
+bool serializeTo(Sink&& sink, const MyData* records, std::size_t count, RecordEncoding encoding, int compressionLevel) {
+    RecordStreamHeader header;
+    header.flags = encoding == RecordEncoding::VarintIds ? kRecordFlagVarintIds : 0;
+    if (compressionLevel > 0) {
+        header.flags |= kRecordFlagCompressed;
+    }
+    header.recordCount = count;
+    unsigned char headerBytes[kRecordStreamHeaderSize];
+    encodeRecordStreamHeader(header, headerBytes);
+    if (!sink(headerBytes, sizeof(headerBytes))) {
+        return false;
+    }
+
+    BlockCompressor compressor(compressionLevel);
+    std::vector<unsigned char> batch, scratch;
+    std::uint32_t prevId = 0;
+    for (std::size_t done = 0; done < count; ) {
+        const std::size_t n = std::min(count - done, kSerializationBatchRecords);
+        batch.clear();
+        appendEncodedBatch(records + done, n, encoding, prevId, batch);
+        if (compressionLevel > 0) {
+            compressBatch(compressor, batch, scratch);
+        }
+        if (!sink(batch.data(), batch.size())) {
+            return false;
+        }
+        done += n;
+    }
+    return true;
+}
+
+/*
+ * Function: serialize()
+ *
+ * Purpose: Write a header followed by `count` records in the wire layout.
+ *          A `compressionLevel` of 1-9 block-compresses each batch (0 = uncompressed).
+ *          (The project targets C++17, so a pointer + count pair stands in for std::span.)
+ * Returns: false if the stream reported an error.
+ */
+bool serialize(std::ostream& out, const MyData* records, std::size_t count,
+               RecordEncoding encoding = RecordEncoding::Fixed, int compressionLevel = 0) {
+    return serializeTo([&out](const unsigned char* data, std::size_t size) {
+        out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        return static_cast<bool>(out);
+    }, records, count, encoding, compressionLevel);
+}
+
+bool serialize(std::ostream& out, const std::vector<MyData>& records,
+               RecordEncoding encoding = RecordEncoding::Fixed, int compressionLevel = 0) {
+    return serialize(out, records.data(), records.size(), encoding, compressionLevel);
+}
+
+/*
+ * Function: decodeBatch()
+ *
+ * Purpose: Decode `n` records from an encoded batch that must span exactly `size` bytes.
+ * Returns: false if the batch is malformed.
+ */
+bool decodeBatch(const unsigned char* data, std::size_t size, std::size_t n, bool varintIds,
+                 std::uint32_t& prevId, std::vector<std::uint32_t>& deltas, std::vector<MyData>& records) {
+    if (!varintIds) {
+        if (size != n * kWireRecordSize) {
+            return false;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            records.push_back(decodeRecord(data + i * kWireRecordSize));
+        }
+        return true;
+    }
+
+    if (size < 4) {
+        return false;
+    }
+    const std::size_t idBytes = loadLittleEndian<std::uint32_t>(data);
+    if (idBytes > streamVByteMaxBytes(n) || size != 4 + idBytes + n * 8) {
+        return false; // Corrupted length
+    }
+    deltas.resize(n);
+    if (streamVByteDecode(data + 4, idBytes, deltas.data(), n) != idBytes) {
+        return false;
+    }
+    const unsigned char* values = data + 4 + idBytes;
+    for (std::size_t i = 0; i < n; ++i) {
+        prevId += static_cast<std::uint32_t>(zigzagDecode32(deltas[i]));
+        const std::uint64_t bits = loadLittleEndian<std::uint64_t>(values + i * 8);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        records.emplace_back(static_cast<std::int32_t>(prevId), value);
+    }
+    return true;
+}
+
+/*
+ * Function: deserializePagedRecords()
+ *
+ * Purpose: Read the paged layout (kRecordFlagPagedRecords) that follows a 16-byte header: skip the
+ *          header padding, then decode kRecordsPerPage records per page and skip each page's padding.
+ * Returns: false if the stream ends early.
+ */
+bool deserializePagedRecords(std::istream& in, std::uint64_t recordCount, std::vector<MyData>& records) {
+    std::vector<unsigned char> page(kRecordPageBytes);
+    if (recordCount > 0 &&
+        !in.read(reinterpret_cast<char*>(page.data()), static_cast<std::streamsize>(kRecordPageBytes - kRecordStreamHeaderSize))) {
+        return false;
+    }
+    for (std::uint64_t remaining = recordCount; remaining > 0; ) {
+        const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, kRecordsPerPage));
+        if (!in.read(reinterpret_cast<char*>(page.data()), static_cast<std::streamsize>(kRecordPageBytes))) {
+            return false; // Every page, the last one included, is padded to kRecordPageBytes
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            records.push_back(decodeRecord(page.data() + i * kWireRecordSize));
+        }
+        remaining -= n;
+    }
+    return true;
+}
+
+/*
+ * Function: deserialize()
+ *
+ * Purpose: Read a stream produced by serialize() (any encoding, compressed or not) or by
+ *          serializeWithIndex() (paged records) and append its records to `records`.
+ *          The reservation is capped so that a corrupted record count cannot trigger a huge allocation
+ *          before any data has been read.
+ * Returns: false on a bad header, a malformed batch, or if the stream ends before `recordCount`
+ *          records were read.
+ */
+bool deserialize(std::istream& in, std::vector<MyData>& records) {
+    RecordStreamHeader header;
+    if (!readRecordStreamHeader(in, header)) {
+        return false;
+    }
+    const bool varintIds = (header.flags & kRecordFlagVarintIds) != 0;
+    const bool compressed = (header.flags & kRecordFlagCompressed) != 0;
+
+    const std::uint64_t reserveLimit = 1u << 20;
+    records.reserve(records.size() + static_cast<std::size_t>(std::min(header.recordCount, reserveLimit)));
+    if ((header.flags & kRecordFlagPagedRecords) != 0) {
+        return !varintIds && !compressed && deserializePagedRecords(in, header.recordCount, records);
+    }
+
+    std::vector<unsigned char> batch(kSerializationBatchRecords * kWireRecordSize);
+    std::vector<unsigned char> stored;
+    std::vector<std::uint32_t> deltas;
+    std::uint32_t prevId = 0;
+    for (std::uint64_t remaining = header.recordCount; remaining > 0; ) {
+        const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, kSerializationBatchRecords));
+        // Upper bound on an encoded batch; anything larger is corruption.
+        const std::size_t maxBatchBytes = std::max(n * kWireRecordSize, 4 + streamVByteMaxBytes(n) + n * 8);
+        std::size_t batchBytes = 0;
+        if (compressed) {
+            unsigned char lengths[8];
+            if (!in.read(reinterpret_cast<char*>(lengths), sizeof(lengths))) {
+                return false;
+            }
+            batchBytes = loadLittleEndian<std::uint32_t>(lengths);
+            const std::size_t storedBytes = loadLittleEndian<std::uint32_t>(lengths + 4);
+            if (batchBytes > maxBatchBytes || storedBytes > batchBytes) {
+                return false;
+            }
+            batch.resize(batchBytes);
+            stored.resize(storedBytes);
+            if (!in.read(reinterpret_cast<char*>(stored.data()), static_cast<std::streamsize>(storedBytes))) {
+                return false;
+            }
+            if (storedBytes == batchBytes) {
+                batch.swap(stored);
+            } else if (!blockDecompress(stored.data(), storedBytes, batch.data(), batchBytes)) {
+                return false;
+            }
+        } else if (!varintIds) {
+            batchBytes = n * kWireRecordSize;
+            batch.resize(batchBytes);
+            if (!in.read(reinterpret_cast<char*>(batch.data()), static_cast<std::streamsize>(batchBytes))) {
+                return false; // Truncated stream
+            }
+        } else {
+            batch.resize(4);
+            if (!in.read(reinterpret_cast<char*>(batch.data()), 4)) {
+                return false;
+            }
+            const std::size_t idBytes = loadLittleEndian<std::uint32_t>(batch.data());
+            if (idBytes > streamVByteMaxBytes(n)) {
+                return false; // Corrupted length
+            }
+            batchBytes = 4 + idBytes + n * 8;
+            batch.resize(batchBytes);
+            if (!in.read(reinterpret_cast<char*>(batch.data() + 4), static_cast<std::streamsize>(batchBytes - 4))) {
+                return false;
+            }
+        }
+        if (!decodeBatch(batch.data(), batchBytes, n, varintIds, prevId, deltas, records)) {
+            return false;
+        }
+        remaining -= n;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Section 5: Benchmark - Per-Object memcpy Path vs. Batched Wire Format
+//------------------------------------------------------------------------------
+
+/*
+ * Function: benchmarkSerialization()
+ *
+ * Purpose: Persist and reload the same records twice: once with the raw per-object write()/read() of
+ *          `sizeof(MyData)` bytes, and once with serialize()/deserialize().
+ *          Prints elapsed time, throughput and file size for each path.
+ */
+void benchmarkSerialization(std::size_t recordCount) {
+    using Clock = std::chrono::steady_clock;
+    std::cout << "\n--- Serialization Benchmark (" << recordCount << " records) ---\n";
+
+    std::vector<MyData> records;
+    records.reserve(recordCount);
+    for (std::size_t i = 0; i < recordCount; ++i) {
+        records.emplace_back(static_cast<int>(i), i * 0.5);
+    }
+
+    const char* legacyFile = "records_legacy.bin";
+    const char* batchedFile = "records_batched.bin";
+
+    auto report = [](const char* label, Clock::duration elapsed, std::size_t bytes) {
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        std::cout << label << ": " << seconds * 1000.0 << " ms, "
+                  << (seconds > 0 ? bytes / seconds / 1e6 : 0.0) << " MB/s, " << bytes << " bytes\n";
+    };
+
+    // Per-object path (one write/read of sizeof(MyData) per record)
+    auto start = Clock::now();
+    {
+        std::ofstream ofs(legacyFile, std::ios::binary);
+        for (const MyData& r : records) {
+            ofs.write(reinterpret_cast<const char*>(&r), sizeof(r));
+        }
+    }
+    report("Per-object write", Clock::now() - start, recordCount * sizeof(MyData));
+
+    start = Clock::now();
+    std::vector<MyData> legacyLoaded;
+    legacyLoaded.reserve(recordCount);
+    {
+        std::ifstream ifs(legacyFile, std::ios::binary);
+        MyData r(0, 0.0);
+        while (ifs.read(reinterpret_cast<char*>(&r), sizeof(r))) {
+            legacyLoaded.push_back(r);
+        }
+    }
+    report("Per-object read ", Clock::now() - start, legacyLoaded.size() * sizeof(MyData));
+
+    // Batched wire-format path
+    start = Clock::now();
+    {
+        std::ofstream ofs(batchedFile, std::ios::binary);
+        if (!serialize(ofs, records)) {
+            std::cerr << "Error: Batched serialization to '" << batchedFile << "' failed.\n";
+        }
+    }
+    report("Batched write   ", Clock::now() - start, kRecordStreamHeaderSize + recordCount * kWireRecordSize);
+
+    start = Clock::now();
+    std::vector<MyData> reloaded;
+    {
+        std::ifstream ifs(batchedFile, std::ios::binary);
+        if (!deserialize(ifs, reloaded)) {
+            std::cerr << "Error: Batched deserialization from '" << batchedFile << "' failed.\n";
+        }
+    }
+    report("Batched read    ", Clock::now() - start, kRecordStreamHeaderSize + reloaded.size() * kWireRecordSize);
+
+    // Batched path with varint-encoded ids
+    start = Clock::now();
+    std::size_t varintBytes = 0;
+    {
+        std::ofstream ofs(batchedFile, std::ios::binary);
+        if (serialize(ofs, records, RecordEncoding::VarintIds)) {
+            varintBytes = static_cast<std::size_t>(ofs.tellp());
+        } else {
+            std::cerr << "Error: Varint-id serialization to '" << batchedFile << "' failed.\n";
+        }
+    }
+    report("Varint-id write ", Clock::now() - start, varintBytes);
+
+    start = Clock::now();
+    reloaded.clear();
+    {
+        std::ifstream ifs(batchedFile, std::ios::binary);
+        if (!deserialize(ifs, reloaded) || reloaded.size() != recordCount) {
+            std::cerr << "Error: Varint-id deserialization from '" << batchedFile << "' failed.\n";
+        }
+    }
+    report("Varint-id read  ", Clock::now() - start, varintBytes);
+
+    // Batched path with block-compressed batches
+    start = Clock::now();
+    std::size_t compressedBytes = 0;
+    {
+        std::ofstream ofs(batchedFile, std::ios::binary);
+        if (serialize(ofs, records, RecordEncoding::Fixed, 1)) {
+            compressedBytes = static_cast<std::size_t>(ofs.tellp());
+        } else {
+            std::cerr << "Error: Compressed serialization to '" << batchedFile << "' failed.\n";
+        }
+    }
+    report("Compressed write", Clock::now() - start, compressedBytes);
+
+    start = Clock::now();
+    reloaded.clear();
+    {
+        std::ifstream ifs(batchedFile, std::ios::binary);
+        if (!deserialize(ifs, reloaded) || reloaded.size() != recordCount) {
+            std::cerr << "Error: Compressed deserialization from '" << batchedFile << "' failed.\n";
+        }
+    }
+    report("Compressed read ", Clock::now() - start, compressedBytes);
+
+    std::remove(legacyFile);
+    std::remove(batchedFile);
+}
+
+/*
+ * Function: benchmarkBatchCompression()
+ *
+ * Purpose: Encodes `recordCount` records into serialize()-sized batches (both encodings) and measures
+ *          the block compressor on them. Values repeat with a period of 64 records, like a sensor that
+ *          cycles through a fixed set of readings.
+ */
+void benchmarkBatchCompression(std::size_t recordCount) {
+    std::vector<MyData> records;
+    records.reserve(recordCount);
+    for (std::size_t i = 0; i < recordCount; ++i) {
+        records.emplace_back(static_cast<int>(i), 20.0 + (i % 64) * 0.125);
+    }
+
+    for (RecordEncoding encoding : {RecordEncoding::Fixed, RecordEncoding::VarintIds}) {
+        std::vector<std::vector<unsigned char>> batches;
+        std::uint32_t prevId = 0;
+        for (std::size_t done = 0; done < recordCount; done += kSerializationBatchRecords) {
+            batches.emplace_back();
+            appendEncodedBatch(records.data() + done, std::min(recordCount - done, kSerializationBatchRecords),
+                               encoding, prevId, batches.back());
+        }
+        std::cout << "\n--- Block Compression of " << (encoding == RecordEncoding::Fixed ? "Fixed" : "Varint-id")
+                  << " Batches (" << recordCount << " records) ---\n";
+        benchmarkBlockCompression(batches);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Section 6: Demonstration
+//------------------------------------------------------------------------------
+
+const char* const kDataFile = "data.bin";
+
+/*
+ * Function: serializeData()
+ *
+ * Purpose: Save a few MyData objects to data.bin in the versioned wire format.
+ * Returns: false if the file cannot be opened or written.
+ */
+bool serializeData() {
+    std::cout << "\n--- Object Serialization ---\n";
+
+    const std::vector<MyData> records = {MyData(1, 3.14159), MyData(2, 2.71828), MyData(-3, 1.41421)};
+    std::ofstream ofs(kDataFile, std::ios::binary);
+    if (!ofs || !serialize(ofs, records)) {
+        std::cerr << "Error: Cannot serialize records to '" << kDataFile << "'.\n";
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Function: deserializeData()
+ *
+ * Purpose: Load data.bin back. deserialize() validates the magic, version and flags and rejects a
+ *          truncated or malformed file instead of returning partial objects.
+ */
+void deserializeData() {
+    std::cout << "\n--- Object Deserialization ---\n";
+
+    std::vector<MyData> loaded;
+    std::ifstream ifs(kDataFile, std::ios::binary);
+    if (!ifs || !deserialize(ifs, loaded)) {
+        std::cerr << "Error: Cannot deserialize records from '" << kDataFile << "'.\n";
+        return;
+    }
+    for (const MyData& r : loaded) {
+        std::cout << "Deserialized Data - ID: " << r.id << ", Value: " << r.value << std::endl;
+    }
+}
+
+void runBinarySerializationExamples() {
+    std::cout << "\n--- Versioned Batched Serialization ---\n";
+
+    if (serializeData()) {
+        deserializeData();
+    }
+
+    benchmarkSerialization(1000000);
+
+    std::cout << "\nBlock compression round-trip self-check: "
+              << (fuzzBlockCompression(500) ? "passed" : "FAILED") << "\n";
+    benchmarkBatchCompression(1000000);
+}
+
+#endif // BINARYSERIALIZATION_H
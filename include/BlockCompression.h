@@ -0,0 +1,438 @@
+#ifndef BLOCKCOMPRESSION_H
+#define BLOCKCOMPRESSION_H
+
+#include <iostream>       // For standard input/output operations (cout, cerr)
+#include <vector>         // For hash tables and benchmark buffers
+#include <memory>         // For std::unique_ptr (uninitialized chain table)
+#include <cstdint>        // For fixed-width integer types
+#include <cstring>        // For memcpy
+#include <chrono>         // For timing the benchmark
+#include <random>         // For fuzz inputs
+#include <algorithm>      // For std::min/std::max/std::fill
+
+//------------------------------------------------------------------------------
+// Section 1: LZ77 Block Compression in the LZ4 Style
+//------------------------------------------------------------------------------
+
+/*
+ * Why a byte-oriented LZ compressor?
+ * - Serialized MyData batches are highly repetitive: neighbouring records share most of their id bytes
+ *   and the exponent/high mantissa bytes of their values.
+ * - Entropy coders (Huffman, ANS) squeeze harder but decode one symbol at a time. An LZ77 format that
+ *   only copies literals and earlier byte ranges decodes with memcpy-sized moves at several GB/s.
+ *
+ * Block format (compatible with the LZ4 block format):
+ *   A block is a list of sequences. Each sequence is:
+ *     token        1 byte: high nibble = literal length, low nibble = match length - 4 (15 = "more follows")
+ *     [lit ext]    bytes of 255 while the length continues, then the remainder (only if the nibble is 15)
+ *     literals     `literal length` raw bytes
+ *     offset       uint16 little-endian distance back to the match (1..65535)
+ *     [match ext]  as for literals
+ *   The last sequence has literals only and no offset. The last 5 bytes are always literals and no
+ *   match starts within the final 12 bytes, so decoders can finish with a single literal copy.
+ *
+ * Match finding (BlockCompressor):
+ *   - Greedy: at each position take the best match found and jump past it.
+ *   - A hash of the next 4 bytes indexes `head_`, the last position with that hash; `chain_` links every
+ *     position to the previous one with the same hash, within the 64 KiB window.
+ *   - `level` sets how many chain candidates are examined: level 1 checks one (fastest, LZ4 default),
+ *     level 9 checks 256 (slower, better ratio). Decompression speed does not depend on the level.
+ */
+
+const std::size_t kLzMinMatch = 4;
+const std::size_t kLzLastLiterals = 5;
+const std::size_t kLzMatchFindLimit = 12;
+const std::size_t kLzMaxOffset = 65535;
+const int kLzMaxLevel = 9;
+
+/*
+ * Function: blockCompressBound()
+ *
+ * Purpose: Worst-case compressed size of `size` input bytes (incompressible data grows by ~0.4%).
+ */
+std::size_t blockCompressBound(std::size_t size) {
+    return size + size / 255 + 16;
+}
+
+class BlockCompressor {
+public:
+    explicit BlockCompressor(int level = 1)
+        : level_(std::max(1, std::min(level, kLzMaxLevel))),
+          head_(kHashSize),
+          chain_(new std::uint16_t[kWindowSize]) {}
+
+    int level() const { return level_; }
+
+    /*
+     * Function: compress()
+     *
+     * Purpose: Compress `size` bytes from `src` into `dst`, which must hold blockCompressBound(size) bytes.
+     * Returns: the number of bytes written to `dst`.
+     */
+    std::size_t compress(const unsigned char* src, std::size_t size, unsigned char* dst) {
+        unsigned char* op = dst;
+        std::size_t anchor = 0;
+        if (size >= kLzMatchFindLimit + 1) {
+            std::fill(head_.begin(), head_.end(), -1);
+            const std::size_t matchFindLimit = size - kLzMatchFindLimit;
+            const std::size_t matchLimit = size - kLzLastLiterals;
+            const unsigned maxAttempts = 1u << (level_ - 1);
+            std::size_t ip = 0;
+            unsigned misses = 0;
+            while (ip < matchFindLimit) {
+                std::size_t matchPos = 0, matchLen = 0;
+                findMatch(src, ip, matchLimit, maxAttempts, matchPos, matchLen);
+                insert(src, ip);
+                if (matchLen < kLzMinMatch) {
+                    // Skip faster through incompressible regions, like LZ4's acceleration.
+                    ip += 1 + (misses++ >> 6);
+                    continue;
+                }
+                misses = 0;
+                while (ip > anchor && matchPos > 0 && src[ip - 1] == src[matchPos - 1]) {
+                    --ip;
+                    --matchPos;
+                    ++matchLen;
+                }
+                op = writeSequence(op, src + anchor, ip - anchor, ip - matchPos, matchLen);
+                const std::size_t matchEnd = ip + matchLen;
+                if (level_ > 1) {
+                    for (std::size_t p = ip + 1; p < matchEnd && p < matchFindLimit; ++p) {
+                        insert(src, p);
+                    }
+                } else if (matchEnd - 2 < matchFindLimit) {
+                    insert(src, matchEnd - 2);
+                }
+                ip = matchEnd;
+                anchor = ip;
+            }
+        }
+        // Last literals
+        const std::size_t literals = size - anchor;
+        unsigned char* token = op++;
+        *token = static_cast<unsigned char>(std::min<std::size_t>(literals, 15) << 4);
+        op = writeLength(op, literals);
+        std::memcpy(op, src + anchor, literals);
+        return static_cast<std::size_t>(op + literals - dst);
+    }
+
+private:
+    static const std::size_t kHashBits = 14;
+    static const std::size_t kHashSize = std::size_t(1) << kHashBits;
+    static const std::size_t kWindowSize = 65536;
+
+    static std::uint32_t read32(const unsigned char* p) {
+        std::uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static std::size_t hash(std::uint32_t v) {
+        return (v * 2654435761u) >> (32 - kHashBits);
+    }
+
+    void insert(const unsigned char* src, std::size_t pos) {
+        std::int32_t& head = head_[hash(read32(src + pos))];
+        const std::size_t delta = head < 0 ? 0 : pos - static_cast<std::size_t>(head);
+        chain_[pos & (kWindowSize - 1)] = static_cast<std::uint16_t>(delta > kLzMaxOffset ? 0 : delta);
+        head = static_cast<std::int32_t>(pos);
+    }
+
+    // Walk the hash chain from `ip` and keep the longest match (stops at delta 0 = end of chain).
+    void findMatch(const unsigned char* src, std::size_t ip, std::size_t matchLimit, unsigned maxAttempts,
+                   std::size_t& bestPos, std::size_t& bestLen) const {
+        const std::uint32_t sequence = read32(src + ip);
+        std::int32_t candidate = head_[hash(sequence)];
+        for (unsigned attempt = 0; attempt < maxAttempts && candidate >= 0; ++attempt) {
+            const std::size_t pos = static_cast<std::size_t>(candidate);
+            if (ip - pos > kLzMaxOffset) {
+                break;
+            }
+            if (read32(src + pos) == sequence) {
+                const std::size_t len = kLzMinMatch + commonLength(src + pos + kLzMinMatch, src + ip + kLzMinMatch,
+                                                                   src + matchLimit);
+                if (len > bestLen) {
+                    bestLen = len;
+                    bestPos = pos;
+                }
+            }
+            const std::uint16_t delta = chain_[pos & (kWindowSize - 1)];
+            if (delta == 0) {
+                break;
+            }
+            candidate -= delta;
+        }
+    }
+
+    static std::size_t commonLength(const unsigned char* a, const unsigned char* b, const unsigned char* bLimit) {
+        const unsigned char* start = b;
+        while (b + 8 <= bLimit) {
+            std::uint64_t x, y;
+            std::memcpy(&x, a, 8);
+            std::memcpy(&y, b, 8);
+            if (x != y) break;
+            a += 8;
+            b += 8;
+        }
+        while (b < bLimit && *a == *b) {
+            ++a;
+            ++b;
+        }
+        return static_cast<std::size_t>(b - start);
+    }
+
+    static unsigned char* writeLength(unsigned char* op, std::size_t length) {
+        if (length >= 15) {
+            length -= 15;
+            for (; length >= 255; length -= 255) *op++ = 255;
+            *op++ = static_cast<unsigned char>(length);
+        }
+        return op;
+    }
+
+    static unsigned char* writeSequence(unsigned char* op, const unsigned char* literals, std::size_t literalLength,
+                                        std::size_t offset, std::size_t matchLength) {
+        unsigned char* token = op++;
+        const std::size_t matchCode = matchLength - kLzMinMatch;
+        *token = static_cast<unsigned char>((std::min<std::size_t>(literalLength, 15) << 4) |
+                                            std::min<std::size_t>(matchCode, 15));
+        op = writeLength(op, literalLength);
+        std::memcpy(op, literals, literalLength);
+        op += literalLength;
+        *op++ = static_cast<unsigned char>(offset);
+        *op++ = static_cast<unsigned char>(offset >> 8);
+        return writeLength(op, matchCode);
+    }
+
+    int level_;
+    std::vector<std::int32_t> head_;
+    std::unique_ptr<std::uint16_t[]> chain_; // Only read via positions inserted into the current block
+};
+
+//------------------------------------------------------------------------------
+// Section 2: Decompression
+//------------------------------------------------------------------------------
+
+/*
+ * Function: blockDecompress()
+ *
+ * Purpose: Decode a block produced by BlockCompressor::compress() into exactly `dstSize` bytes.
+ *          Matches are copied 8 bytes at a time when the output has room for the overshoot, falling
+ *          back to a byte loop only near the end of the block.
+ * Returns: true if the block decoded to exactly `dstSize` bytes.
+ */
+bool blockDecompress(const unsigned char* src, std::size_t srcSize, unsigned char* dst, std::size_t dstSize) {
+    const unsigned char* ip = src;
+    const unsigned char* const iend = src + srcSize;
+    unsigned char* op = dst;
+    unsigned char* const oend = dst + dstSize;
+
+    auto readLength = [&](std::size_t& length) {
+        if (length != 15) return true;
+        unsigned char b;
+        do {
+            if (ip == iend) return false;
+            b = *ip++;
+            length += b;
+        } while (b == 255);
+        return true;
+    };
+
+    while (ip < iend) {
+        const unsigned token = *ip++;
+        std::size_t literals = token >> 4;
+        if (literals < 15 && iend - ip >= 18 && oend - op >= 16) {
+            // Short literal run with room to spare: copy a fixed 16 bytes instead of a variable memcpy.
+            std::memcpy(op, ip, 16);
+        } else if (!readLength(literals) ||
+                   literals > static_cast<std::size_t>(iend - ip) || literals > static_cast<std::size_t>(oend - op)) {
+            return false;
+        } else {
+            std::memcpy(op, ip, literals);
+        }
+        ip += literals;
+        op += literals;
+        if (ip == iend) {
+            break; // Last sequence: literals only
+        }
+
+        if (iend - ip < 2) return false;
+        const std::size_t offset = ip[0] | (static_cast<std::size_t>(ip[1]) << 8);
+        ip += 2;
+        std::size_t matchLength = token & 15;
+        if (offset == 0 || offset > static_cast<std::size_t>(op - dst) || !readLength(matchLength)) {
+            return false;
+        }
+        matchLength += kLzMinMatch;
+        if (matchLength > static_cast<std::size_t>(oend - op)) {
+            return false;
+        }
+
+        const unsigned char* match = op - offset;
+        // An overlapping run (offset < 8) first writes `distance` bytes, which can exceed matchLength.
+        std::size_t distance = offset;
+        while (distance < 8) distance += offset;
+        if (std::max(offset < 8 ? distance : 0, matchLength) + 8 <= static_cast<std::size_t>(oend - op)) {
+            unsigned char* const copyEnd = op + matchLength;
+            if (offset < 8) {
+                // Overlapping run: the output repeats with period `offset`, so after writing the first
+                // `distance` bytes one at a time it can be copied 8 bytes at a time from `distance` back.
+                for (std::size_t i = 0; i < distance; ++i) {
+                    op[i] = match[i];
+                }
+                op += distance;
+                match = op - distance;
+            }
+            while (op < copyEnd) {
+                std::memcpy(op, match, 8);
+                op += 8;
+                match += 8;
+            }
+            op = copyEnd;
+        } else {
+            for (std::size_t i = 0; i < matchLength; ++i) {
+                op[i] = match[i];
+            }
+            op += matchLength;
+        }
+    }
+    return op == oend;
+}
+
+//------------------------------------------------------------------------------
+// Section 3: Round-Trip Self-Check and Benchmark
+//------------------------------------------------------------------------------
+
+/*
+ * Function: fuzzBlockCompression()
+ *
+ * Purpose: Round-trips `iterations` random buffers with varying size and redundancy through every
+ *          level, then feeds truncated and bit-flipped blocks to the decoder, which must reject or
+ *          decode them without touching memory outside the output buffer.
+ * Returns: true if every round trip reproduced its input.
+ */
+bool fuzzBlockCompression(std::size_t iterations) {
+    std::mt19937 gen(12345);
+    std::vector<unsigned char> input, compressed;
+    for (std::size_t iter = 0; iter < iterations; ++iter) {
+        const std::size_t size = gen() % (iter % 10 == 0 ? 200000 : 2000);
+        const unsigned alphabet = 1 + gen() % 256;
+        const unsigned repeatChance = gen() % 100;
+        // Every third input repeats with a short period (1..8), which exercises overlapping matches.
+        const std::size_t period = iter % 3 == 0 ? 1 + gen() % 8 : 0;
+        input.resize(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            if (period != 0 && i >= period) {
+                input[i] = gen() % 64 == 0 ? static_cast<unsigned char>(gen()) : input[i - period];
+            } else if (i >= 8 && gen() % 100 < repeatChance) {
+                input[i] = input[i - 1 - gen() % std::min<std::size_t>(i, 70000)];
+            } else {
+                input[i] = static_cast<unsigned char>(gen() % alphabet);
+            }
+        }
+
+        const int level = 1 + static_cast<int>(iter % kLzMaxLevel);
+        BlockCompressor compressor(level);
+        compressed.resize(blockCompressBound(size));
+        const std::size_t compressedSize = compressor.compress(input.data(), size, compressed.data());
+
+        // Exact-size heap buffers, so an AddressSanitizer build catches any read or write past either end.
+        std::unique_ptr<unsigned char[]> block(new unsigned char[compressedSize]);
+        std::unique_ptr<unsigned char[]> output(new unsigned char[size]);
+        if (compressedSize > compressed.size()) {
+            std::cerr << "Error: Block exceeds blockCompressBound (size " << size << ", level " << level << ").\n";
+            return false;
+        }
+        std::memcpy(block.get(), compressed.data(), compressedSize);
+        if (!blockDecompress(block.get(), compressedSize, output.get(), size) ||
+            (size != 0 && std::memcmp(output.get(), input.data(), size) != 0)) {
+            std::cerr << "Error: Block round trip failed (size " << size << ", level " << level << ").\n";
+            return false;
+        }
+
+        // Hand-built valid block: short literal runs and short, mostly overlapping matches right up to
+        // the end of the output, which the compressor's end-of-block rules rarely produce.
+        std::vector<unsigned char> crafted, expected;
+        const int sequences = 1 + static_cast<int>(gen() % 4);
+        for (int seq = 0; seq <= sequences; ++seq) {
+            const std::size_t literals = (expected.empty() ? 1 : 0) + gen() % 9;
+            const std::size_t matchLength = kLzMinMatch + gen() % 12;
+            const bool last = seq == sequences;
+            crafted.push_back(static_cast<unsigned char>((literals << 4) | (last ? 0 : matchLength - kLzMinMatch)));
+            for (std::size_t i = 0; i < literals; ++i) {
+                expected.push_back(static_cast<unsigned char>(gen()));
+                crafted.push_back(expected.back());
+            }
+            if (last) break;
+            const std::size_t offset = 1 + gen() % std::min<std::size_t>(expected.size(), 16);
+            crafted.push_back(static_cast<unsigned char>(offset));
+            crafted.push_back(0);
+            for (std::size_t i = 0; i < matchLength; ++i) {
+                expected.push_back(expected[expected.size() - offset]);
+            }
+        }
+        std::unique_ptr<unsigned char[]> craftedBlock(new unsigned char[crafted.size()]);
+        std::unique_ptr<unsigned char[]> craftedOutput(new unsigned char[expected.size()]);
+        std::memcpy(craftedBlock.get(), crafted.data(), crafted.size());
+        if (!blockDecompress(craftedBlock.get(), crafted.size(), craftedOutput.get(), expected.size()) ||
+            std::memcmp(craftedOutput.get(), expected.data(), expected.size()) != 0) {
+            std::cerr << "Error: Hand-built block failed to decode (" << crafted.size() << " bytes).\n";
+            return false;
+        }
+
+        // Corrupted input must not crash; the result is irrelevant.
+        if (compressedSize != 0) {
+            block[gen() % compressedSize] ^= static_cast<unsigned char>(1u << (gen() % 8));
+            blockDecompress(block.get(), compressedSize, output.get(), size);
+            std::unique_ptr<unsigned char[]> truncated(new unsigned char[compressedSize / 2]);
+            std::memcpy(truncated.get(), block.get(), compressedSize / 2);
+            blockDecompress(truncated.get(), compressedSize / 2, output.get(), size);
+        }
+    }
+    return true;
+}
+
+/*
+ * Function: benchmarkBlockCompression()
+ *
+ * Purpose: Compresses `batches` serialized MyData batches of `batchBytes` each at several levels and
+ *          reports compression ratio and compression/decompression throughput.
+ */
+void benchmarkBlockCompression(const std::vector<std::vector<unsigned char>>& batches) {
+    using Clock = std::chrono::steady_clock;
+    std::size_t rawBytes = 0, largest = 0;
+    for (const auto& b : batches) {
+        rawBytes += b.size();
+        largest = std::max(largest, b.size());
+    }
+    std::vector<std::vector<unsigned char>> compressed(batches.size());
+    std::vector<unsigned char> output(largest);
+
+    for (int level : {1, 4, 9}) {
+        BlockCompressor compressor(level);
+        std::size_t compressedBytes = 0;
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < batches.size(); ++i) {
+            compressed[i].resize(blockCompressBound(batches[i].size()));
+            compressed[i].resize(compressor.compress(batches[i].data(), batches[i].size(), compressed[i].data()));
+            compressedBytes += compressed[i].size();
+        }
+        const double compressSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        bool ok = true;
+        start = Clock::now();
+        const int repeats = 5;
+        for (int r = 0; r < repeats; ++r) {
+            for (std::size_t i = 0; i < batches.size(); ++i) {
+                ok &= blockDecompress(compressed[i].data(), compressed[i].size(), output.data(), batches[i].size());
+            }
+        }
+        const double decompressSeconds = std::chrono::duration<double>(Clock::now() - start).count() / repeats;
+
+        std::cout << "Level " << level << ": ratio " << static_cast<double>(rawBytes) / compressedBytes
+                  << ", compress " << rawBytes / compressSeconds / 1e6 << " MB/s, decompress "
+                  << rawBytes / decompressSeconds / 1e9 << " GB/s" << (ok ? "" : " (DECODE ERROR)") << "\n";
+    }
+}
+
+#endif // BLOCKCOMPRESSION_H
@@ -107,40 +107,17 @@ public:
     MyData(int id, double value) : id(id), value(value) {} // Constructor
 };
 
-// Function to demonstrate serialization:
-void serializeData() {
-    std::cout << "\n--- Object Serialization ---\n";
-
-    MyData data(1, 3.14159); // Create a sample MyData object.
-
-    std::ofstream ofs("data.bin", std::ios::binary); // Open file "data.bin" in binary mode for writing.
-
-    // Write the Object to the File:
-    ofs.write(reinterpret_cast<const char*>(&data), sizeof(data)); // Write the raw bytes of the object to the file.
-
-    ofs.close();
-}
-
-// Function to demonstrate deserialization:
-void deserializeData() {
-    std::cout << "\n--- Object Deserialization ---\n";
-
-    MyData data(0, 0.0); // Create a MyData object to hold the deserialized data.
-
-    std::ifstream ifs("data.bin", std::ios::binary); // Open the file in binary mode for reading.
-
-    // Read the Object from the File:
-    ifs.read(reinterpret_cast<char*>(&data), sizeof(data)); // Read the raw bytes from the file into the object.
-
-    std::cout << "Deserialized Data - ID: " << data.id << ", Value: " << data.value << std::endl;
-
-    ifs.close();
-}
+/*
+ * Persisting MyData:
+ *   - Writing the object with `write(reinterpret_cast<const char*>(&data), sizeof(data))`, as
+ *     binaryReadWrite() does for an int, would copy the padding after `id` and tie the file to this
+ *     compiler's layout and this machine's endianness.
+ *   - serializeData() and deserializeData() in BinarySerialization.h store MyData through an explicit,
+ *     versioned little-endian layout instead.
+ */
 
 void runByteStreamingExamples() {
     binaryReadWrite(); // Demonstrate basic binary file I/O
-    serializeData();  // Demonstrate object serialization
-    deserializeData(); // Demonstrate object deserialization
 }
 
 #endif // BYTESTREAMING_H
@@ -4,7 +4,8 @@
 #include <iostream>
 #include <vector>
 
-void optimizeVectorAccess(std::vector<int>& v) {
+template <typename Allocator>
+void optimizeVectorAccess(std::vector<int, Allocator>& v) {
     for (size_t i = 0; i < v.size(); ++i) {
         v[i] += 10;
     }
@@ -0,0 +1,618 @@
+#ifndef COLUMNARFORMAT_H
+#define COLUMNARFORMAT_H
+
+#include <iostream>       // For standard input/output operations (cout, cerr)
+#include <fstream>        // For reading/writing columnar files
+#include <vector>         // For column buffers and the chunk directory
+#include <cstdint>        // For fixed-width integer types used by the on-disk layout
+#include <cstring>        // For memcpy/memcmp
+#include <cstdio>         // For std::remove (cleanup of demo files)
+#include <chrono>         // For timing the decode paths
+#include <algorithm>      // For std::min/std::max
+
+#include "ByteStreaming.h"       // For MyData
+#include "BinarySerialization.h" // For the little-endian load/store helpers
+#include "CpuFeatures.h"         // For AVX2 runtime dispatch and bit counting
+
+//------------------------------------------------------------------------------
+// Section 1: Row-Oriented vs. Column-Oriented Storage
+//------------------------------------------------------------------------------
+
+/*
+ * Row-oriented (serializeData()): id, padding, value, id, padding, value, ...
+ *   - Reading only `value` still drags every `id` (and the padding) through the disk and the cache.
+ *
+ * Column-oriented (this module): all ids of a chunk, then all values of the chunk.
+ *   - A scan that aggregates `value` seeks straight to the value blocks and never reads the id blocks.
+ *   - Each column holds one type with similar neighbouring values, so it compresses well:
+ *       - id:    delta encoding + frame of reference + bit packing. Consecutive ids usually differ by a
+ *                small, similar amount, so each delta needs only a few bits instead of 32.
+ *       - value: Gorilla-style XOR compression. Neighbouring doubles often share sign, exponent and
+ *                leading mantissa bits; XOR with the previous value leaves mostly zeros, and only the
+ *                "meaningful" middle bits are stored (a single bit when the value repeats).
+ *
+ * File layout (all integers little-endian):
+ *   Header (24 bytes):   char[4] "CCCF", uint16 version, uint16 reserved, uint64 rows,
+ *                        uint32 chunk count, uint32 rows per chunk
+ *   Chunks:              [id block][value block] for each chunk
+ *   Directory:           per chunk: uint32 rows, uint64 id offset, uint32 id bytes,
+ *                                   uint64 value offset, uint32 value bytes (28 bytes)
+ *   Trailer (12 bytes):  uint64 directory offset, char[4] "CCCF"
+ *
+ *   id block:    int32 first id, int32 min delta, uint8 bit width,
+ *                (rows - 1) packed values (delta - min delta), LSB-first, plus 8 zero bytes of padding
+ *                so decoders may always load 8 bytes at any packed offset.
+ *   value block: Gorilla bit stream, MSB-first.
+ *
+ * Decoding:
+ * - The id column is data-parallel: every packed delta sits at a computable bit offset, and the ids
+ *   are a prefix sum of the deltas. With AVX2, eight deltas are gathered, shifted and masked at once
+ *   and an in-register prefix sum reconstructs eight ids per step (scalar fallback otherwise).
+ * - The Gorilla stream is inherently sequential (each value's bit window depends on the previous one),
+ *   so it is decoded scalar; the win for value scans comes from reading only the value blocks.
+ */
+
+const char kColumnarMagic[4] = {'C', 'C', 'C', 'F'};
+const std::uint16_t kColumnarVersion = 1;
+const std::size_t kColumnarHeaderSize = 24;
+const std::size_t kColumnarTrailerSize = 12;
+const std::size_t kColumnarDirectoryEntrySize = 28;
+const std::size_t kColumnarRowsPerChunk = 65536;
+const std::size_t kIdBlockHeaderSize = 9;
+const std::size_t kPackedPadding = 8;
+
+struct ColumnChunkInfo {
+    std::uint32_t rows = 0;
+    std::uint64_t idOffset = 0;
+    std::uint32_t idBytes = 0;
+    std::uint64_t valueOffset = 0;
+    std::uint32_t valueBytes = 0;
+};
+
+//------------------------------------------------------------------------------
+// Section 2: Bit Streams for the Gorilla Value Column
+//------------------------------------------------------------------------------
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<unsigned char>& out) : out_(out) {}
+
+    // Append the low `bits` bits of `v`, most significant bit first.
+    void write(std::uint64_t v, int bits) {
+        if (bits > 32) {
+            write(v >> 32, bits - 32);
+            write(v & 0xFFFFFFFFu, 32);
+            return;
+        }
+        if (bits == 0) return;
+        acc_ = (acc_ << bits) | (v & ((std::uint64_t(1) << bits) - 1));
+        pending_ += bits;
+        while (pending_ >= 8) {
+            pending_ -= 8;
+            out_.push_back(static_cast<unsigned char>(acc_ >> pending_));
+        }
+    }
+
+    void finish() {
+        if (pending_ > 0) {
+            out_.push_back(static_cast<unsigned char>(acc_ << (8 - pending_)));
+            pending_ = 0;
+        }
+    }
+
+private:
+    std::vector<unsigned char>& out_;
+    std::uint64_t acc_ = 0;
+    int pending_ = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const unsigned char* data, std::size_t size) : data_(data), size_(size) {}
+
+    // Read `bits` bits (most significant first). Reading past the end yields zero bits.
+    std::uint64_t read(int bits) {
+        if (bits > 32) {
+            const std::uint64_t hi = read(bits - 32);
+            return (hi << 32) | read(32);
+        }
+        if (bits == 0) return 0;
+        while (available_ < bits) {
+            acc_ = (acc_ << 8) | (pos_ < size_ ? data_[pos_] : 0u);
+            ++pos_;
+            available_ += 8;
+        }
+        available_ -= bits;
+        return (acc_ >> available_) & ((std::uint64_t(1) << bits) - 1);
+    }
+
+    bool overrun() const { return pos_ > size_; }
+
+private:
+    const unsigned char* data_;
+    std::size_t size_;
+    std::size_t pos_ = 0;
+    std::uint64_t acc_ = 0;
+    int available_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// Section 3: Column Codecs
+//------------------------------------------------------------------------------
+
+/*
+ * Function: encodeIdColumn()
+ *
+ * Purpose: Delta + frame-of-reference + bit-pack `count` ids (count >= 1) and append the block to `out`.
+ *          Deltas use wrapping 32-bit arithmetic, so any id sequence round-trips exactly.
+ */
+void encodeIdColumn(const MyData* records, std::size_t count, std::vector<unsigned char>& out) {
+    std::vector<std::uint32_t> deltas(count > 0 ? count - 1 : 0);
+    std::int32_t minDelta = 0;
+    for (std::size_t i = 1; i < count; ++i) {
+        deltas[i - 1] = static_cast<std::uint32_t>(records[i].id) - static_cast<std::uint32_t>(records[i - 1].id);
+        const std::int32_t d = static_cast<std::int32_t>(deltas[i - 1]);
+        minDelta = (i == 1) ? d : std::min(minDelta, d);
+    }
+    std::uint32_t maxAdjusted = 0;
+    for (std::uint32_t& d : deltas) {
+        d -= static_cast<std::uint32_t>(minDelta);
+        maxAdjusted = std::max(maxAdjusted, d);
+    }
+    const int bitWidth = maxAdjusted == 0 ? 0 : 64 - countLeadingZeros64(maxAdjusted);
+
+    const std::size_t start = out.size();
+    const std::size_t packedBytes = (deltas.size() * bitWidth + 7) / 8;
+    out.resize(start + kIdBlockHeaderSize + packedBytes + kPackedPadding, 0);
+    unsigned char* block = out.data() + start;
+    storeLittleEndian<std::uint32_t>(block, static_cast<std::uint32_t>(records[0].id));
+    storeLittleEndian<std::uint32_t>(block + 4, static_cast<std::uint32_t>(minDelta));
+    block[8] = static_cast<unsigned char>(bitWidth);
+
+    unsigned char* packed = block + kIdBlockHeaderSize;
+    for (std::size_t i = 0; i < deltas.size() && bitWidth > 0; ++i) {
+        const std::size_t bit = i * bitWidth;
+        std::uint64_t word = loadLittleEndian<std::uint64_t>(packed + bit / 8);
+        word |= static_cast<std::uint64_t>(deltas[i]) << (bit % 8);
+        storeLittleEndian<std::uint64_t>(packed + bit / 8, word);
+    }
+}
+
+// Scalar reference decoder for an id block holding `count` ids.
+void decodeIdColumnScalar(const unsigned char* block, std::size_t count, std::int32_t* ids) {
+    std::uint32_t id = loadLittleEndian<std::uint32_t>(block);
+    const std::uint32_t minDelta = loadLittleEndian<std::uint32_t>(block + 4);
+    const int bitWidth = block[8];
+    const unsigned char* packed = block + kIdBlockHeaderSize;
+    const std::uint64_t mask = (std::uint64_t(1) << bitWidth) - 1;
+
+    ids[0] = static_cast<std::int32_t>(id);
+    for (std::size_t i = 1; i < count; ++i) {
+        const std::size_t bit = (i - 1) * bitWidth;
+        const std::uint64_t word = loadLittleEndian<std::uint64_t>(packed + bit / 8);
+        id += static_cast<std::uint32_t>((word >> (bit % 8)) & mask) + minDelta;
+        ids[i] = static_cast<std::int32_t>(id);
+    }
+}
+
+#if CPUFEATURES_X86
+/*
+ * Function: decodeIdColumnAvx2()
+ *
+ * Purpose: AVX2 id decoder. For bit widths up to 25 a packed value plus its bit shift fits in one
+ *          32-bit load, so eight values are fetched with a single gather at byte offsets, aligned with a
+ *          per-lane variable shift and masked. The eight deltas are then turned into ids with a
+ *          log-step prefix sum inside the register, seeded with the last id of the previous step.
+ *          Wider widths use the scalar decoder.
+ */
+CPUFEATURES_TARGET("avx2")
+void decodeIdColumnAvx2(const unsigned char* block, std::size_t count, std::int32_t* ids) {
+    const int bitWidth = block[8];
+    if (bitWidth > 25 || count < 9 || (count - 1) * std::uint64_t(bitWidth) >= 0x7FFFFFFFu) {
+        decodeIdColumnScalar(block, count, ids);
+        return;
+    }
+    const std::uint32_t minDelta = loadLittleEndian<std::uint32_t>(block + 4);
+    const unsigned char* packed = block + kIdBlockHeaderSize;
+
+    ids[0] = static_cast<std::int32_t>(loadLittleEndian<std::uint32_t>(block));
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i mask = _mm256_set1_epi32(static_cast<int>((std::uint32_t(1) << bitWidth) - 1));
+    const __m256i bias = _mm256_set1_epi32(static_cast<int>(minDelta));
+    const __m256i seven = _mm256_set1_epi32(7);
+    __m256i running = _mm256_set1_epi32(ids[0]);
+
+    const std::size_t deltaCount = count - 1;
+    std::size_t i = 0;
+    for (; i + 8 <= deltaCount; i += 8) {
+        const __m256i bitPos = _mm256_mullo_epi32(_mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)), lane),
+                                                  _mm256_set1_epi32(bitWidth));
+        const __m256i byteOffset = _mm256_srli_epi32(bitPos, 3);
+        const __m256i shift = _mm256_and_si256(bitPos, seven);
+        __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(packed), byteOffset, 1);
+        v = _mm256_and_si256(_mm256_srlv_epi32(v, shift), mask);
+        v = _mm256_add_epi32(v, bias);
+
+        // Inclusive prefix sum across the 8 lanes
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+        const __m256i lowTotal = _mm256_shuffle_epi32(_mm256_permute2x128_si256(v, v, 0x08), 0xFF);
+        v = _mm256_add_epi32(v, lowTotal);
+        v = _mm256_add_epi32(v, running);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(ids + 1 + i), v);
+        running = _mm256_permutevar8x32_epi32(v, seven);
+    }
+
+    std::uint32_t id = static_cast<std::uint32_t>(ids[i]);
+    const std::uint64_t scalarMask = (std::uint64_t(1) << bitWidth) - 1;
+    for (; i < deltaCount; ++i) {
+        const std::size_t bit = i * bitWidth;
+        const std::uint64_t word = loadLittleEndian<std::uint64_t>(packed + bit / 8);
+        id += static_cast<std::uint32_t>((word >> (bit % 8)) & scalarMask) + minDelta;
+        ids[i + 1] = static_cast<std::int32_t>(id);
+    }
+}
+#endif
+
+void decodeIdColumn(const unsigned char* block, std::size_t count, std::int32_t* ids) {
+#if CPUFEATURES_X86
+    if (cpuHasAvx2()) {
+        decodeIdColumnAvx2(block, count, ids);
+        return;
+    }
+#endif
+    decodeIdColumnScalar(block, count, ids);
+}
+
+/*
+ * Function: encodeValueColumn()
+ *
+ * Purpose: Gorilla XOR compression of `count` doubles (count >= 1):
+ *          - first value: 64 raw bits
+ *          - XOR == 0:                                     '0'
+ *          - XOR fits the previous leading/trailing window: '10' + meaningful bits
+ *          - otherwise:                                     '11' + 5-bit leading zeros + 6-bit length + bits
+ */
+void encodeValueColumn(const MyData* records, std::size_t count, std::vector<unsigned char>& out) {
+    BitWriter writer(out);
+    std::uint64_t prev;
+    std::memcpy(&prev, &records[0].value, sizeof(prev));
+    writer.write(prev, 64);
+
+    int prevLeading = -1;
+    int prevTrailing = 0;
+    for (std::size_t i = 1; i < count; ++i) {
+        std::uint64_t cur;
+        std::memcpy(&cur, &records[i].value, sizeof(cur));
+        const std::uint64_t x = cur ^ prev;
+        prev = cur;
+        if (x == 0) {
+            writer.write(0, 1);
+            continue;
+        }
+        const int leading = std::min(countLeadingZeros64(x), 31);
+        const int trailing = countTrailingZeros64(x);
+        if (prevLeading >= 0 && leading >= prevLeading && trailing >= prevTrailing) {
+            writer.write(0x2, 2);
+            writer.write(x >> prevTrailing, 64 - prevLeading - prevTrailing);
+        } else {
+            const int significant = 64 - leading - trailing;
+            writer.write(0x3, 2);
+            writer.write(static_cast<std::uint64_t>(leading), 5);
+            writer.write(static_cast<std::uint64_t>(significant & 63), 6); // 64 is stored as 0
+            writer.write(x >> trailing, significant);
+            prevLeading = leading;
+            prevTrailing = trailing;
+        }
+    }
+    writer.finish();
+}
+
+// Decode `count` doubles from a Gorilla stream. Returns false if the stream is too short or corrupt.
+bool decodeValueColumn(const unsigned char* data, std::size_t size, std::size_t count, double* values) {
+    if (count == 0) return true;
+    BitReader reader(data, size);
+    std::uint64_t prev = reader.read(64);
+    std::memcpy(&values[0], &prev, sizeof(prev));
+
+    int leading = 0;
+    int trailing = 0;
+    for (std::size_t i = 1; i < count; ++i) {
+        if (reader.read(1) != 0) {
+            if (reader.read(1) != 0) {
+                leading = static_cast<int>(reader.read(5));
+                int significant = static_cast<int>(reader.read(6));
+                if (significant == 0) significant = 64;
+                if (leading + significant > 64) return false; // Corrupt window: trailing would be negative
+                trailing = 64 - leading - significant;
+            }
+            prev ^= reader.read(64 - leading - trailing) << trailing;
+        }
+        std::memcpy(&values[i], &prev, sizeof(prev));
+    }
+    return !reader.overrun();
+}
+
+//------------------------------------------------------------------------------
+// Section 4: Columnar Writer and Reader
+//------------------------------------------------------------------------------
+
+/*
+ * Function: writeColumnar()
+ *
+ * Purpose: Write `count` records as a columnar file, `rowsPerChunk` rows per chunk.
+ *          Offsets are tracked by the writer, so `out` does not need to be seekable.
+ */
+bool writeColumnar(std::ostream& out, const MyData* records, std::size_t count,
+                   std::size_t rowsPerChunk = kColumnarRowsPerChunk) {
+    rowsPerChunk = std::max<std::size_t>(1, std::min<std::size_t>(rowsPerChunk, 0xFFFFFFFFu));
+    const std::size_t chunkCount = (count + rowsPerChunk - 1) / rowsPerChunk;
+
+    unsigned char header[kColumnarHeaderSize] = {};
+    std::memcpy(header, kColumnarMagic, sizeof(kColumnarMagic));
+    storeLittleEndian<std::uint16_t>(header + 4, kColumnarVersion);
+    storeLittleEndian<std::uint64_t>(header + 8, count);
+    storeLittleEndian<std::uint32_t>(header + 16, static_cast<std::uint32_t>(chunkCount));
+    storeLittleEndian<std::uint32_t>(header + 20, static_cast<std::uint32_t>(rowsPerChunk));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    std::uint64_t offset = kColumnarHeaderSize;
+    std::vector<ColumnChunkInfo> directory;
+    std::vector<unsigned char> buffer;
+    for (std::size_t first = 0; first < count; first += rowsPerChunk) {
+        const std::size_t rows = std::min(rowsPerChunk, count - first);
+        ColumnChunkInfo info;
+        info.rows = static_cast<std::uint32_t>(rows);
+
+        buffer.clear();
+        encodeIdColumn(records + first, rows, buffer);
+        info.idOffset = offset;
+        info.idBytes = static_cast<std::uint32_t>(buffer.size());
+        encodeValueColumn(records + first, rows, buffer);
+        info.valueOffset = offset + info.idBytes;
+        info.valueBytes = static_cast<std::uint32_t>(buffer.size() - info.idBytes);
+
+        out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        offset += buffer.size();
+        directory.push_back(info);
+    }
+
+    const std::uint64_t directoryOffset = offset;
+    buffer.assign(directory.size() * kColumnarDirectoryEntrySize + kColumnarTrailerSize, 0);
+    unsigned char* p = buffer.data();
+    for (const ColumnChunkInfo& info : directory) {
+        storeLittleEndian<std::uint32_t>(p, info.rows);
+        storeLittleEndian<std::uint64_t>(p + 4, info.idOffset);
+        storeLittleEndian<std::uint32_t>(p + 12, info.idBytes);
+        storeLittleEndian<std::uint64_t>(p + 16, info.valueOffset);
+        storeLittleEndian<std::uint32_t>(p + 24, info.valueBytes);
+        p += kColumnarDirectoryEntrySize;
+    }
+    storeLittleEndian<std::uint64_t>(p, directoryOffset);
+    std::memcpy(p + 8, kColumnarMagic, sizeof(kColumnarMagic));
+    out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(out);
+}
+
+/*
+ * Class: ColumnarReader
+ *
+ * Purpose: Opens a columnar file by reading its trailer and chunk directory, then reads individual
+ *          column blocks on demand. bytesRead() counts the payload bytes fetched from the file, which
+ *          makes the saving of column-only scans visible.
+ */
+class ColumnarReader {
+public:
+    explicit ColumnarReader(const char* path) : in_(path, std::ios::binary) {
+        if (!in_ || !readDirectory()) {
+            in_.close();
+        }
+    }
+
+    bool isOpen() const { return in_.is_open(); }
+    explicit operator bool() const { return in_.is_open(); }
+    std::uint64_t rowCount() const { return rows_; }
+    std::size_t chunkCount() const { return chunks_.size(); }
+    std::uint64_t bytesRead() const { return bytesRead_; }
+    const ColumnChunkInfo& chunk(std::size_t c) const { return chunks_[c]; }
+
+    // Decode the id column of chunk `c` into `ids` (resized to the chunk's row count).
+    bool readIds(std::size_t c, std::vector<std::int32_t>& ids) {
+        const ColumnChunkInfo& info = chunks_[c];
+        if (info.rows == 0 || !readBlock(info.idOffset, info.idBytes)) return false;
+        if (block_.size() < kIdBlockHeaderSize || block_[8] > 32) return false;
+        const std::size_t packedNeeded = kIdBlockHeaderSize + ((info.rows - 1) * std::size_t(block_[8]) + 7) / 8 + kPackedPadding;
+        if (block_.size() < packedNeeded) return false;
+        ids.resize(info.rows);
+        decodeIdColumn(block_.data(), info.rows, ids.data());
+        return true;
+    }
+
+    // Decode the value column of chunk `c` into `values` (resized to the chunk's row count).
+    bool readValues(std::size_t c, std::vector<double>& values) {
+        const ColumnChunkInfo& info = chunks_[c];
+        if (info.rows == 0 || !readBlock(info.valueOffset, info.valueBytes)) return false;
+        values.resize(info.rows);
+        return decodeValueColumn(block_.data(), block_.size(), info.rows, values.data());
+    }
+
+    // Aggregate the value column without touching any id block.
+    bool sumValues(double& sum) {
+        std::vector<double> values;
+        sum = 0.0;
+        for (std::size_t c = 0; c < chunks_.size(); ++c) {
+            if (!readValues(c, values)) return false;
+            for (double v : values) sum += v;
+        }
+        return true;
+    }
+
+    // Reassemble full rows.
+    bool readAll(std::vector<MyData>& records) {
+        std::vector<std::int32_t> ids;
+        std::vector<double> values;
+        records.reserve(records.size() + static_cast<std::size_t>(rows_));
+        for (std::size_t c = 0; c < chunks_.size(); ++c) {
+            if (!readIds(c, ids) || !readValues(c, values)) return false;
+            for (std::size_t i = 0; i < ids.size(); ++i) {
+                records.emplace_back(ids[i], values[i]);
+            }
+        }
+        return true;
+    }
+
+private:
+    bool readDirectory() {
+        unsigned char header[kColumnarHeaderSize];
+        if (!in_.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+            std::memcmp(header, kColumnarMagic, sizeof(kColumnarMagic)) != 0 ||
+            loadLittleEndian<std::uint16_t>(header + 4) != kColumnarVersion) {
+            return false;
+        }
+        rows_ = loadLittleEndian<std::uint64_t>(header + 8);
+        const std::uint32_t chunkCount = loadLittleEndian<std::uint32_t>(header + 16);
+
+        unsigned char trailer[kColumnarTrailerSize];
+        in_.seekg(-static_cast<std::streamoff>(kColumnarTrailerSize), std::ios::end);
+        const std::streamoff trailerPos = in_.tellg();
+        if (!in_.read(reinterpret_cast<char*>(trailer), sizeof(trailer)) ||
+            std::memcmp(trailer + 8, kColumnarMagic, sizeof(kColumnarMagic)) != 0) {
+            return false;
+        }
+        const std::uint64_t directoryOffset = loadLittleEndian<std::uint64_t>(trailer);
+        // Every size below is bounded by the file before anything is allocated from it.
+        if (trailerPos < static_cast<std::streamoff>(kColumnarHeaderSize) || directoryOffset < kColumnarHeaderSize ||
+            directoryOffset > std::uint64_t(trailerPos) ||
+            std::uint64_t(chunkCount) * kColumnarDirectoryEntrySize != std::uint64_t(trailerPos) - directoryOffset) {
+            return false;
+        }
+
+        std::vector<unsigned char> directory(chunkCount * kColumnarDirectoryEntrySize);
+        in_.seekg(static_cast<std::streamoff>(directoryOffset));
+        if (!in_.read(reinterpret_cast<char*>(directory.data()), static_cast<std::streamsize>(directory.size()))) {
+            return false;
+        }
+        chunks_.resize(chunkCount);
+        for (std::size_t c = 0; c < chunkCount; ++c) {
+            const unsigned char* p = directory.data() + c * kColumnarDirectoryEntrySize;
+            chunks_[c].rows = loadLittleEndian<std::uint32_t>(p);
+            chunks_[c].idOffset = loadLittleEndian<std::uint64_t>(p + 4);
+            chunks_[c].idBytes = loadLittleEndian<std::uint32_t>(p + 12);
+            chunks_[c].valueOffset = loadLittleEndian<std::uint64_t>(p + 16);
+            chunks_[c].valueBytes = loadLittleEndian<std::uint32_t>(p + 24);
+        }
+        return validateChunks(directoryOffset);
+    }
+
+    // Blocks must lie between the header and the directory, and each row costs at least one bit of
+    // its value block, which bounds the row counts (and the vectors sized from them) by the file.
+    bool validateChunks(std::uint64_t directoryOffset) const {
+        std::uint64_t totalRows = 0;
+        for (const ColumnChunkInfo& info : chunks_) {
+            if (info.idOffset < kColumnarHeaderSize || info.idOffset > directoryOffset ||
+                info.idBytes > directoryOffset - info.idOffset ||
+                info.valueOffset < kColumnarHeaderSize || info.valueOffset > directoryOffset ||
+                info.valueBytes > directoryOffset - info.valueOffset ||
+                info.rows > std::uint64_t(info.valueBytes) * 8) {
+                return false;
+            }
+            totalRows += info.rows;
+        }
+        return totalRows == rows_;
+    }
+
+    bool readBlock(std::uint64_t offset, std::uint32_t bytes) {
+        block_.resize(bytes);
+        in_.clear();
+        in_.seekg(static_cast<std::streamoff>(offset));
+        if (!in_.read(reinterpret_cast<char*>(block_.data()), bytes)) {
+            return false;
+        }
+        bytesRead_ += bytes;
+        return true;
+    }
+
+    std::ifstream in_;
+    std::uint64_t rows_ = 0;
+    std::vector<ColumnChunkInfo> chunks_;
+    std::vector<unsigned char> block_;
+    std::uint64_t bytesRead_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// Section 5: Demonstration
+//------------------------------------------------------------------------------
+
+/*
+ * Function: runColumnarFormatExamples()
+ *
+ * Purpose: Writes sensor-like records (steadily increasing ids, slowly varying values) in the row
+ *          layout and the columnar layout, compares file sizes, verifies a full round trip, shows
+ *          how many bytes a value-only aggregation reads, and times scalar vs. dispatched id decoding.
+ */
+void runColumnarFormatExamples() {
+    using Clock = std::chrono::steady_clock;
+    std::cout << "\n--- Columnar Storage for MyData ---\n";
+
+    const std::size_t recordCount = 1000000;
+    std::vector<MyData> records;
+    records.reserve(recordCount);
+    for (std::size_t i = 0; i < recordCount; ++i) {
+        const int id = static_cast<int>(i * 3 + (i % 7 == 0 ? 1 : 0));
+        const double value = 20.0 + static_cast<double>((i / 50) % 40) * 0.5; // Values repeat in runs
+        records.emplace_back(id, value);
+    }
+
+    const char* filename = "records_columnar.bin";
+    {
+        std::ofstream ofs(filename, std::ios::binary);
+        if (!ofs || !writeColumnar(ofs, records.data(), records.size())) {
+            std::cerr << "Error: Cannot write columnar file '" << filename << "'.\n";
+            return;
+        }
+    }
+
+    ColumnarReader reader(filename);
+    if (!reader) {
+        std::cerr << "Error: Cannot open columnar file '" << filename << "'.\n";
+        return;
+    }
+    std::uint64_t idBytes = 0, valueBytes = 0;
+    for (std::size_t c = 0; c < reader.chunkCount(); ++c) {
+        idBytes += reader.chunk(c).idBytes;
+        valueBytes += reader.chunk(c).valueBytes;
+    }
+    std::cout << "Row layout (sizeof(MyData)): " << recordCount * sizeof(MyData) << " bytes\n";
+    std::cout << "Columnar layout:             " << idBytes + valueBytes << " bytes (id "
+              << idBytes << ", value " << valueBytes << ")\n";
+
+    std::vector<MyData> reloaded;
+    const bool roundTrip = reader.readAll(reloaded) && reloaded.size() == records.size() &&
+        std::equal(records.begin(), records.end(), reloaded.begin(),
+                   [](const MyData& a, const MyData& b) { return a.id == b.id && a.value == b.value; });
+    std::cout << "Round trip: " << (roundTrip ? "OK" : "MISMATCH") << "\n";
+
+    ColumnarReader valueScan(filename);
+    double sum = 0.0;
+    valueScan.sumValues(sum);
+    std::cout << "Value-only aggregation: sum " << sum << ", read " << valueScan.bytesRead()
+              << " bytes instead of " << recordCount * sizeof(MyData) << "\n";
+
+    // Id decode throughput: scalar reference vs. dispatched (AVX2 when available)
+    std::vector<unsigned char> idBlock;
+    encodeIdColumn(records.data(), records.size(), idBlock);
+    std::vector<std::int32_t> ids(records.size());
+    auto start = Clock::now();
+    decodeIdColumnScalar(idBlock.data(), records.size(), ids.data());
+    const double scalarMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    start = Clock::now();
+    decodeIdColumn(idBlock.data(), records.size(), ids.data());
+    const double dispatchedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::cout << "Id decode: scalar " << scalarMs << " ms, " << (cpuHasAvx2() ? "AVX2 " : "scalar (no AVX2) ")
+              << dispatchedMs << " ms, last id " << ids.back() << "\n";
+
+    std::remove(filename);
+}
+
+#endif // COLUMNARFORMAT_H
@@ -6,9 +6,15 @@
 #include <mutex>          // For mutual exclusion to synchronize access to shared resources like std::cout.
 #include <vector>         // A dynamic array for storing a collection of thread objects.
 #include <future>         // For asynchronous tasks and retrieving their results.
-#include <cmath>          // For mathematical operations like square root, sine, and cosine, used in the workload simulation.
+#include <cmath>          // For the reference sine, cosine and square root used by the accuracy check.
 #include <chrono>         // For high-resolution time measurement to assess performance.
-#include <random>         // For generating random numbers used in the workload simulation.
+#include <random>         // For std::random_device, which seeds each task's generator.
+#include <algorithm>      // For std::min and std::max.
+#include <cstring>        // For std::memcpy (bit pattern to double).
+#include <cstdint>        // For the 64-bit generator state.
+#include <cstddef>        // For std::size_t.
+#include "CpuFeatures.h"  // For cpuHasAvx2() and CPUFEATURES_TARGET, which select the SIMD kernel at runtime.
+#include "ThreadPool.h"   // For sharedThreadPool(), which runs the tasks on reusable worker threads.
 
 // Global Mutex for Synchronization (std::mutex):
 /*
@@ -18,18 +24,237 @@
 */
 std::mutex mtx2;
 
-// Function to Simulate Workload (void simulateWork):
+// Workload Kernel Constants:
+/*
+* - kWorkBlockSize: Random inputs are generated this many at a time into a buffer, then the math kernel runs over
+*   the whole buffer. Generating and computing in separate tight loops lets both be vectorized.
+* - kWorkFlopsPerItem: Floating-point operations per work item, counted from the kernel below:
+*   sine polynomial 12, cosine polynomial 13, product 1, square root 1, accumulation 1.
+* - kWorkMaxError: Largest absolute error accepted from the polynomial sine/cosine on the input range [0, 1].
+*/
+const std::size_t kWorkBlockSize = 1024;
+const int kWorkFlopsPerItem = 28;
+const double kWorkMaxError = 1e-9;
+
+// Block Random Number Generator (struct WorkRng):
+/*
+* Purpose: Four independent xorshift64 generators, one per SIMD lane, so the scalar and the AVX2 fill produce the same
+*          sequence. Each step keeps the top 52 bits as the mantissa of a double in [1, 2) and subtracts 1.0, giving a
+*          uniform value in [0, 1) without an integer-to-double conversion (which AVX2 lacks for 64-bit integers).
+*/
+struct WorkRng {
+    std::uint64_t lanes[4];
+};
+
+WorkRng seedWorkRng(std::uint64_t seed) {
+    WorkRng rng;
+    for (std::uint64_t& lane : rng.lanes) {
+        // SplitMix64 spreads one seed over the four lanes (and never yields the all-zero xorshift state in practice)
+        seed += 0x9E3779B97F4A7C15ull;
+        std::uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        lane = (z ^ (z >> 31)) | 1;
+    }
+    return rng;
+}
+
+// Fills out[0..n) with uniform doubles in [0, 1); n must be a multiple of 4.
+void fillUniformScalar(WorkRng& rng, double* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; i += 4) {
+        for (int lane = 0; lane < 4; ++lane) {
+            std::uint64_t s = rng.lanes[lane];
+            s ^= s << 13;
+            s ^= s >> 7;
+            s ^= s << 17;
+            rng.lanes[lane] = s;
+            const std::uint64_t bits = (s >> 12) | 0x3FF0000000000000ull;
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            out[i + lane] = value - 1.0;
+        }
+    }
+}
+
+// Polynomial Sine and Cosine (sinPoly / cosPoly):
+/*
+* Purpose: Taylor polynomials evaluated with Horner's rule in x^2, accurate to about 2e-10 for |x| <= 1, which covers the
+*          workload's input range, so no range reduction is needed. They use only multiplies and adds, which map one-to-one
+*          onto SIMD instructions, whereas std::sin/std::cos are scalar library calls.
+*          - sin x = x + x * x^2 * (-1/3! + x^2 * (1/5! + ... + x^2 * (-1/11!)))
+*          - cos x = 1 + x^2 * (-1/2! + x^2 * (1/4! + ... + x^2 * (1/12!)))
+*/
+const double kSinCoeffs[5] = {-1.0 / 6, 1.0 / 120, -1.0 / 5040, 1.0 / 362880, -1.0 / 39916800};
+const double kCosCoeffs[6] = {-1.0 / 2, 1.0 / 24, -1.0 / 720, 1.0 / 40320, -1.0 / 3628800, 1.0 / 479001600};
+
+double sinPoly(double x) {
+    const double x2 = x * x;
+    double p = kSinCoeffs[4];
+    for (int k = 3; k >= 0; --k) {
+        p = p * x2 + kSinCoeffs[k];
+    }
+    return x * (p * x2) + x;
+}
+
+double cosPoly(double x) {
+    const double x2 = x * x;
+    double p = kCosCoeffs[5];
+    for (int k = 4; k >= 0; --k) {
+        p = p * x2 + kCosCoeffs[k];
+    }
+    return p * x2 + 1.0;
+}
+
+// Sums sqrt(sin(a[i]) * cos(b[i])) for i < n.
+double workKernelScalar(const double* a, const double* b, std::size_t n) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        sum += std::sqrt(sinPoly(a[i]) * cosPoly(b[i]));
+    }
+    return sum;
+}
+
+#if CPUFEATURES_X86
+// AVX2 Kernels:
+/*
+* Purpose: The same generator and polynomials four doubles at a time. The square root uses the vsqrtpd instruction, which
+*          is already a correctly rounded SIMD square root, so it needs no approximation.
+*/
+CPUFEATURES_TARGET("avx2")
+void fillUniformAvx2(WorkRng& rng, double* out, std::size_t n) {
+    __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rng.lanes));
+    const __m256i exponent = _mm256_set1_epi64x(0x3FF0000000000000ll);
+    const __m256d one = _mm256_set1_pd(1.0);
+    for (std::size_t i = 0; i < n; i += 4) {
+        s = _mm256_xor_si256(s, _mm256_slli_epi64(s, 13));
+        s = _mm256_xor_si256(s, _mm256_srli_epi64(s, 7));
+        s = _mm256_xor_si256(s, _mm256_slli_epi64(s, 17));
+        const __m256i bits = _mm256_or_si256(_mm256_srli_epi64(s, 12), exponent);
+        _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_castsi256_pd(bits), one));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(rng.lanes), s);
+}
+
+CPUFEATURES_TARGET("avx2")
+__m256d sinPolyAvx2(__m256d x) {
+    const __m256d x2 = _mm256_mul_pd(x, x);
+    __m256d p = _mm256_set1_pd(kSinCoeffs[4]);
+    for (int k = 3; k >= 0; --k) {
+        p = _mm256_add_pd(_mm256_mul_pd(p, x2), _mm256_set1_pd(kSinCoeffs[k]));
+    }
+    return _mm256_add_pd(_mm256_mul_pd(x, _mm256_mul_pd(p, x2)), x);
+}
+
+CPUFEATURES_TARGET("avx2")
+__m256d cosPolyAvx2(__m256d x) {
+    const __m256d x2 = _mm256_mul_pd(x, x);
+    __m256d p = _mm256_set1_pd(kCosCoeffs[5]);
+    for (int k = 4; k >= 0; --k) {
+        p = _mm256_add_pd(_mm256_mul_pd(p, x2), _mm256_set1_pd(kCosCoeffs[k]));
+    }
+    return _mm256_add_pd(_mm256_mul_pd(p, x2), _mm256_set1_pd(1.0));
+}
+
+CPUFEATURES_TARGET("avx2")
+double workKernelAvx2(const double* a, const double* b, std::size_t n) {
+    __m256d sum = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d product = _mm256_mul_pd(sinPolyAvx2(_mm256_loadu_pd(a + i)), cosPolyAvx2(_mm256_loadu_pd(b + i)));
+        sum = _mm256_add_pd(sum, _mm256_sqrt_pd(product));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, sum);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + workKernelScalar(a + i, b + i, n - i);
+}
+
+// Evaluates both polynomials over x[0..n) (n a multiple of 4); used by the accuracy check.
+CPUFEATURES_TARGET("avx2")
+void sinCosPolyAvx2(const double* x, double* sines, double* cosines, std::size_t n) {
+    for (std::size_t i = 0; i < n; i += 4) {
+        const __m256d v = _mm256_loadu_pd(x + i);
+        _mm256_storeu_pd(sines + i, sinPolyAvx2(v));
+        _mm256_storeu_pd(cosines + i, cosPolyAvx2(v));
+    }
+}
+#endif
+
+// Function to Run the Workload Kernel (double computeWork):
+/*
+* Purpose: Runs `workload` items in blocks: fill two blocks of random inputs, then sum sqrt(sin(a) * cos(b)) over them.
+* Parameters:
+*  - workload (long long): Number of items to compute.
+*  - seed (std::uint64_t): Seeds the block generator; the same seed gives the same inputs on either path.
+*  - useSimd (bool): Selects the AVX2 kernels; callers pass cpuHasAvx2() (or false to force the scalar fallback).
+* Returns: The accumulated result, which the caller consumes so the compiler cannot discard the work.
+*/
+double computeWork(long long workload, std::uint64_t seed, bool useSimd) {
+    alignas(32) double a[kWorkBlockSize];
+    alignas(32) double b[kWorkBlockSize];
+    WorkRng rng = seedWorkRng(seed);
+    double result = 0.0;
+    for (long long done = 0; done < workload; done += kWorkBlockSize) {
+        const std::size_t n = static_cast<std::size_t>(std::min<long long>(kWorkBlockSize, workload - done));
+#if CPUFEATURES_X86
+        if (useSimd) {
+            fillUniformAvx2(rng, a, kWorkBlockSize);
+            fillUniformAvx2(rng, b, kWorkBlockSize);
+            result += workKernelAvx2(a, b, n);
+            continue;
+        }
+#else
+        (void)useSimd;
+#endif
+        fillUniformScalar(rng, a, kWorkBlockSize);
+        fillUniformScalar(rng, b, kWorkBlockSize);
+        result += workKernelScalar(a, b, n);
+    }
+    return result;
+}
+
+// Function to Check the Kernel's Accuracy (double checkWorkAccuracy):
+/*
+* Purpose: Compares the polynomial sine and cosine, scalar and (when available) AVX2, with std::sin and std::cos on a
+*          dense grid over [0, 1], and the SIMD kernel's block sum with the scalar kernel's on the same random inputs.
+* Returns: The largest absolute error seen; the kernel is accepted when it is at most kWorkMaxError.
+*/
+double checkWorkAccuracy() {
+    const std::size_t points = 4096;
+    std::vector<double> x(points), sines(points), cosines(points);
+    for (std::size_t i = 0; i < points; ++i) {
+        x[i] = static_cast<double>(i) / (points - 1);
+    }
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < points; ++i) {
+        maxError = std::max(maxError, std::fabs(sinPoly(x[i]) - std::sin(x[i])));
+        maxError = std::max(maxError, std::fabs(cosPoly(x[i]) - std::cos(x[i])));
+    }
+#if CPUFEATURES_X86
+    if (cpuHasAvx2()) {
+        sinCosPolyAvx2(x.data(), sines.data(), cosines.data(), points);
+        for (std::size_t i = 0; i < points; ++i) {
+            maxError = std::max(maxError, std::fabs(sines[i] - std::sin(x[i])));
+            maxError = std::max(maxError, std::fabs(cosines[i] - std::cos(x[i])));
+        }
+        // Whole kernel, per item: the two paths sum in a different order, so compare the mean
+        const long long items = 1 << 16;
+        maxError = std::max(maxError, std::fabs(computeWork(items, 42, true) - computeWork(items, 42, false)) / items);
+    }
+#endif
+    return maxError;
+}
+
+// Function to Simulate Workload (double simulateWork):
 /*
 * Purpose: This function simulates a computationally intensive task to create a realistic workload for each thread.
 * Parameters:
 *  - threadId (int): An identifier for the thread to distinguish its output.
-*  - workload (int): The amount of work to be simulated, determining the intensity of the computation.
+*  - workload (int): The number of work items to compute, determining the intensity of the computation.
 * Workload Simulation:
-*  - A random number generator is initialized using std::random_device and std::mt19937 to produce non-deterministic sequences.
-*  - A loop iterates 'workload' times, and in each iteration:
-*     - Random numbers between 0.0 and 1.0 are generated using std::uniform_real_distribution.
-*     - These numbers are used in trigonometric calculations (sin, cos) and a square root operation, simulating CPU-intensive work.
-*     - A small delay (100 microseconds) is introduced using std::this_thread::sleep_for to represent real-world scenarios where tasks might have short pauses.
+*  - The block generator is seeded from std::random_device, so every run and every task draws a different sequence.
+*  - computeWork() evaluates sqrt(sin(a) * cos(b)) for `workload` random pairs, using the AVX2 kernel when the CPU
+*    supports it and the scalar polynomials otherwise.
+*  - The sum is returned through the task's future, so the work is observable and cannot be optimized away.
 * Synchronization:
 *  - The std::lock_guard<std::mutex> object `lock(mtx2)` acquires a lock on the mutex `mtx2`.
 *  - This lock ensures that only one thread can access and print to std::cout at a time, preventing jumbled output.
@@ -37,23 +262,61 @@ std::mutex mtx2;
 * Output:
 *  - The thread prints a message indicating its completion after finishing its workload.
 */
-void simulateWork(int threadId, int workload) {
-    // Initialize random number generator
+double simulateWork(int threadId, int workload) {
     std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dist(0.0, 1.0);
-
-    for (int i = 0; i < workload; ++i) {
-        // Simulate work with a random calculation
-        double result = std::sqrt(std::sin(dist(gen)) * std::cos(dist(gen)));
-
-        // Briefly pause the thread (100 microseconds)
-        std::this_thread::sleep_for(std::chrono::microseconds(100));
-    }
+    const std::uint64_t seed = (std::uint64_t(rd()) << 32) ^ rd() ^ std::uint64_t(threadId);
+    const double result = computeWork(workload, seed, cpuHasAvx2());
 
     // Safely print the completion message (protected by the mutex)
     std::lock_guard<std::mutex> lock(mtx2);
     std::cout << "Thread " << threadId << " finished work\n";
+    return result;
+}
+
+// Function to Measure FLOP Throughput (void benchmarkSimulateWork):
+/*
+* Purpose: Reports GFLOP/s of the workload kernel (kWorkFlopsPerItem per item):
+*  - on one thread, scalar fallback vs. AVX2;
+*  - for 1, 2, 4, ... tasks up to the shared pool's worker count (one per hardware thread), as the total and per thread.
+*    Per-thread throughput that stays flat as tasks are added means the kernel scales with the cores.
+*/
+void benchmarkSimulateWork(long long workload) {
+    auto gflops = [&](double items, std::chrono::steady_clock::time_point start) {
+        return items * kWorkFlopsPerItem / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / 1e9;
+    };
+
+    const auto scalarStart = std::chrono::steady_clock::now();
+    volatile double sink = computeWork(workload, 1, false);
+    const double scalarRate = gflops(double(workload), scalarStart);
+    std::cout << "One thread: scalar " << scalarRate << " GFLOP/s";
+    if (cpuHasAvx2()) {
+        const auto simdStart = std::chrono::steady_clock::now();
+        sink = computeWork(workload, 1, true);
+        const double simdRate = gflops(double(workload), simdStart);
+        std::cout << ", AVX2 " << simdRate << " GFLOP/s (" << simdRate / scalarRate << "x)";
+    }
+    std::cout << "\n";
+    (void)sink;
+
+    ThreadPool& pool = sharedThreadPool();
+    const std::size_t maxTasks = std::max<std::size_t>(1, pool.size());
+    for (std::size_t tasks = 1;; tasks = std::min(tasks * 2, maxTasks)) {
+        std::vector<std::future<double>> results;
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t t = 0; t < tasks; ++t) {
+            results.push_back(pool.submit(computeWork, workload, std::uint64_t(t + 1), cpuHasAvx2()));
+        }
+        double total = 0.0;
+        for (auto& result : results) {
+            total += result.get();
+        }
+        const double rate = gflops(double(tasks) * workload, start);
+        std::cout << "  " << tasks << " task(s): " << rate << " GFLOP/s total, " << rate / tasks
+                  << " GFLOP/s per thread (checksum " << total / (double(tasks) * workload) << ")\n";
+        if (tasks == maxTasks) {
+            break;
+        }
+    }
 }
 
 // Main Function for Running Concurrent Programming (void runConcurrentProgramming):
@@ -61,49 +324,59 @@ void simulateWork(int threadId, int workload) {
 * Purpose: This is the main function that orchestrates the concurrent execution of multiple threads.
 * Performance Measurement:
 *  - Records the starting time using std::chrono::high_resolution_clock::now() for later performance analysis.
-* Thread Management:
-*  - Determines the number of threads to create based on the system's hardware concurrency.
-*  - Initializes a vector to store the thread objects.
-*  - A loop creates and launches multiple threads:
-*     - Each thread executes the simulateWork function with a unique thread ID and the same workload.
-*     - The created thread objects are added to the vector.
-* Joining Threads:
-*  - Waits for each thread in the vector to finish by calling the join() method.
-*  - This ensures the main thread doesn't end before all worker threads have completed their tasks.
+* Task Management:
+*  - Determines the number of tasks to submit based on the system's hardware concurrency.
+*  - Initializes a vector to store the futures of the submitted tasks.
+*  - A loop submits the tasks to the shared work-stealing pool (ThreadPool.h):
+*     - Each task executes the simulateWork function with a unique ID and the same workload.
+*     - No thread is created per task; the pool's workers are started once and reused.
+* Waiting for Tasks:
+*  - Waits for each task to finish by calling get() on its future and adds up the results.
+*  - This ensures the main thread doesn't continue before all tasks have completed.
 * Performance Output:
 *  - Records the end time using std::chrono::high_resolution_clock::now().
 *  - Calculates the total time taken by subtracting the start time from the end time.
-*  - Prints the calculated execution time to the console.
+*  - Prints the calculated execution time and the achieved FLOP throughput to the console.
+*  - Checks the polynomial kernel's accuracy, then reports throughput per thread and per task count.
 */
 void runConcurrentProgramming() {
     // Start the performance timer
     const auto startTime = std::chrono::high_resolution_clock::now();
 
-    // Determine the optimal number of threads based on the available hardware threads (cores)
-    const int numThreads = std::thread::hardware_concurrency();
+    // Determine the optimal number of tasks based on the available hardware threads (cores)
+    const int numThreads = std::max(1u, std::thread::hardware_concurrency());
 
-    // Define the workload each thread will execute (adjust this for varying intensity)
+    // Define the workload each task will execute (adjust this for varying intensity)
     const int workloadPerThread = 10000000;
 
-    // Create a vector to store the thread objects for later management
-    std::vector<std::thread> threads;
+    // Create a vector to store the futures of the submitted tasks
+    std::vector<std::future<double>> tasks;
 
-    // Launch multiple threads to perform the work concurrently
+    // Submit the tasks to the shared pool to perform the work concurrently
+    ThreadPool& pool = sharedThreadPool();
     for (int i = 0; i < numThreads; ++i) {
-        // Create a new thread and pass the simulateWork function with its arguments
-        threads.emplace_back(simulateWork, i, workloadPerThread);
+        // Queue the simulateWork function with its arguments; an idle worker runs it
+        tasks.push_back(pool.submit(simulateWork, i, workloadPerThread));
     }
 
-    // Wait for all threads to finish their work before continuing
-    for (auto& th : threads) {
-        th.join();
+    // Wait for all tasks to finish their work before continuing
+    double total = 0.0;
+    for (auto& task : tasks) {
+        total += task.get();
     }
 
     // Stop the performance timer and calculate the elapsed time
     const auto endTime = std::chrono::high_resolution_clock::now();
     const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
 
-    std::cout << "Time taken: " << duration.count() << " microseconds\n";
+    std::cout << "Time taken: " << duration.count() << " microseconds (" << (cpuHasAvx2() ? "AVX2" : "scalar")
+              << " kernel, mean result " << total / (double(numThreads) * workloadPerThread) << ", "
+              << double(numThreads) * workloadPerThread * kWorkFlopsPerItem / duration.count() / 1e3 << " GFLOP/s)\n";
+
+    const double maxError = checkWorkAccuracy();
+    std::cout << "Polynomial sin/cos max error on [0, 1]: " << maxError
+              << (maxError <= kWorkMaxError ? " (ok)" : " (EXCEEDS TOLERANCE)") << "\n";
+    benchmarkSimulateWork(workloadPerThread);
 }
 
 #endif // CONCURRENTPROGRAMMING_H
@@ -0,0 +1,96 @@
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+#include <cstdint>        // For fixed-width integer types used by the bit helpers
+
+//------------------------------------------------------------------------------
+// Section 1: Runtime CPU Feature Detection (SIMD Dispatch)
+//------------------------------------------------------------------------------
+
+/*
+ * Why runtime dispatch?
+ * - The project is compiled for the baseline instruction set, so the compiler cannot assume AVX2 or SSE4.2.
+ * - GCC and Clang can compile individual functions for a newer instruction set with
+ *   __attribute__((target("..."))). Such a function may only be *called* on a CPU that supports it,
+ *   so callers check cpuHas...() once and pick the SIMD path or the portable scalar path.
+ * - On other compilers or non-x86 targets CPUFEATURES_X86 is 0, the checks return false and only the
+ *   scalar paths are compiled.
+ */
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CPUFEATURES_X86 1
+#include <immintrin.h>    // For SSE/AVX intrinsics
+#define CPUFEATURES_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CPUFEATURES_X86 0
+#define CPUFEATURES_TARGET(isa)
+#endif
+
+bool cpuHasSsse3() {
+#if CPUFEATURES_X86
+    static const bool supported = __builtin_cpu_supports("ssse3");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+bool cpuHasSse42() {
+#if CPUFEATURES_X86
+    static const bool supported = __builtin_cpu_supports("sse4.2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+bool cpuHasAvx2() {
+#if CPUFEATURES_X86
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Section 2: Bit Counting Helpers
+//------------------------------------------------------------------------------
+
+// Number of leading zero bits of a non-zero 64-bit value.
+int countLeadingZeros64(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    while (!(x & (std::uint64_t(1) << 63))) { x <<= 1; ++n; }
+    return n;
+#endif
+}
+
+// Number of trailing zero bits of a non-zero 64-bit value.
+int countTrailingZeros64(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1)) { x >>= 1; ++n; }
+    return n;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Section 3: Spin-Wait Hint
+//------------------------------------------------------------------------------
+
+// Tell the CPU we are in a spin loop: on x86 PAUSE saves power and avoids the memory-order
+// mis-speculation penalty when the awaited store arrives.
+void cpuRelax() {
+#if CPUFEATURES_X86
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+#endif // CPUFEATURES_H
@@ -3,6 +3,11 @@
 
 #include <iostream>     // For input/output (cout)
 #include <memory>       // For std::allocator (and for showcasing smart pointer use later)
+#include <vector>       // For the telemetry demo
+#include <thread>       // For the multithreaded telemetry demo
+#include <chrono>       // For timing the allocator hot path
+
+#include "AllocationTelemetry.h" // For lock-free allocation accounting
 
 // ----------------------------------------------------------------------------
 // Section 1: Custom Memory Allocators (Beyond new/delete)
@@ -33,25 +38,34 @@
 // Section 2: Simple Allocator Example (Inheriting from std::allocator)
 //------------------------------------------------------------------------------
 
+// The "SimpleAllocator" telemetry source. A plain function, so every SimpleAllocator<T> instantiation
+// shares this one object (a static inside the class template would be one object per T).
+const AllocationTelemetry& simpleAllocatorTelemetry() {
+    static const AllocationTelemetry source("SimpleAllocator");
+    return source;
+}
+
 /*
  * Class: SimpleAllocator<T>
  *
  * Description: A basic custom allocator that inherits from the standard `std::allocator<T>`.
- *              It overrides the `allocate` and `deallocate` functions to add logging messages.
- *              This provides a way to track the allocation/deallocation process for debugging or monitoring purposes.
+ *              It overrides the `allocate` and `deallocate` functions to record each call in the
+ *              "SimpleAllocator" telemetry source (see AllocationTelemetry.h) instead of printing it.
+ *              Recording takes no locks and does no I/O, so the accounting can stay on in hot code;
+ *              call allocationTelemetrySnapshot() to look at the numbers.
  */
 template <typename T>
 class SimpleAllocator : public std::allocator<T> { // Inherit from the standard allocator
 public:
     // Override the allocate function
     T* allocate(size_t numObjects) {
-        std::cout << "Allocating " << numObjects << " object(s) of type " << typeid(T).name() << "\n"; // Print allocation info
+        simpleAllocatorTelemetry().recordAllocation(numObjects * sizeof(T)); // Count the call and its size class
         return std::allocator<T>::allocate(numObjects); // Call the base class allocator
     }
 
     // Override the deallocate function
     void deallocate(T* p, size_t numObjects) {
-        std::cout << "Deallocating " << numObjects << " object(s) of type " << typeid(T).name() << "\n"; // Print deallocation info
+        simpleAllocatorTelemetry().recordDeallocation(numObjects * sizeof(T));
         std::allocator<T>::deallocate(p, numObjects); // Call the base class deallocator
     }
 };
@@ -91,6 +105,56 @@ void demoCustomAllocator() {
 
     // 6. Deallocate the memory:
     allocator.deallocate(arr, 3);
+
+    // 7. Inspect the telemetry recorded by allocate/deallocate:
+    std::cout << allocationTelemetrySnapshot().toJson() << "\n";
+}
+
+//------------------------------------------------------------------------------
+// Section 4: Telemetry Under Load
+//------------------------------------------------------------------------------
+
+/*
+ * Function: runAllocationTelemetryExamples()
+ *
+ * Purpose: Several threads allocate and free through SimpleAllocator with telemetry on; prints the
+ *          cost per call and the merged snapshot. The old per-call std::cout line cost microseconds
+ *          and serialized all threads on the stream lock.
+ */
+void runAllocationTelemetryExamples() {
+    std::cout << "\n--- Allocation Telemetry ---\n";
+    const unsigned threads = 4;
+    const std::size_t rounds = 200000;
+
+    const AllocationSnapshot before = allocationTelemetrySnapshot();
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([t] {
+            SimpleAllocator<double> allocator;
+            for (std::size_t i = 0; i < rounds; ++i) {
+                const std::size_t n = 1 + (i + t) % 64;
+                double* p = allocator.allocate(n);
+                p[0] = static_cast<double>(i);
+                allocator.deallocate(p, n);
+            }
+        });
+    }
+    for (std::thread& w : workers) {
+        w.join();
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    const AllocationSnapshot after = allocationTelemetrySnapshot();
+    std::uint64_t calls = 0;
+    for (const AllocationSnapshot::Source& s : after.sources) {
+        for (const AllocationSnapshot::Source& b : before.sources) {
+            if (s.name == b.name) calls += s.totalAllocCalls() - b.totalAllocCalls();
+        }
+    }
+    std::cout << threads << " threads, " << calls << " allocate/deallocate pairs: "
+              << ns / (threads * rounds) << " ns per pair including malloc/free\n";
+    std::cout << after.toJson() << "\n";
 }
 
 #endif // CUSTOMMEMORYALLOCATORS_H
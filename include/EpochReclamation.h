@@ -0,0 +1,587 @@
+#ifndef EPOCHRECLAMATION_H
+#define EPOCHRECLAMATION_H
+
+#include <iostream>       // For standard input/output operations (cout)
+#include <atomic>         // For the global epoch, thread records and hazard slots
+#include <mutex>          // For the orphaned-limbo list
+#include <thread>         // For the stress threads
+#include <vector>         // For limbo lists and hazard snapshots
+#include <memory>         // For weak_ptr in the read-cost comparison
+#include <algorithm>      // For std::sort, std::binary_search, std::max
+#include <chrono>         // For timing the stress run and the read-cost comparison
+#include <cstdint>        // For std::uint64_t
+#include <cstddef>        // For std::size_t
+
+// ThreadSanitizer does not model stand-alone fences, so sanitized builds use read-modify-writes instead.
+#if defined(__SANITIZE_THREAD__)
+#define EPOCHRECLAMATION_TSAN 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define EPOCHRECLAMATION_TSAN 1
+#endif
+#endif
+#ifndef EPOCHRECLAMATION_TSAN
+#define EPOCHRECLAMATION_TSAN 0
+#endif
+
+// membarrier() lets readers get away with a compiler-only fence (Linux 4.14+).
+#if !EPOCHRECLAMATION_TSAN && __has_include(<linux/membarrier.h>) && __has_include(<sys/syscall.h>)
+#include <linux/membarrier.h> // For MEMBARRIER_CMD_PRIVATE_EXPEDITED
+#include <sys/syscall.h>      // For SYS_membarrier
+#include <unistd.h>           // For syscall
+#define EPOCHRECLAMATION_HAS_MEMBARRIER 1
+#else
+#define EPOCHRECLAMATION_HAS_MEMBARRIER 0
+#endif
+
+//------------------------------------------------------------------------------
+// Section 1: Epochs, Hazards and Fences
+//------------------------------------------------------------------------------
+
+/*
+ * Epoch-based reclamation (EBR) with a hazard-pointer fallback:
+ * - A lock-free structure cannot delete a node it has just unlinked: another thread may still be reading
+ *   it. weak_ptr solves this with two atomic read-modify-writes per access on a shared counter; EBR
+ *   instead defers the delete until every reader that could have seen the node has moved on.
+ * - Readers open an EpochGuard (publishing the global epoch in their thread record) and load shared
+ *   pointers through guard.protect(), which also publishes the pointer in one of the thread's hazard
+ *   slots. Both are plain stores to the reader's own cache line; the matching full fence is paid by the
+ *   reclaimer (membarrier) rather than by every reader.
+ * - Writers unlink a node and call retire(ptr, deleter). The node goes on the calling thread's limbo list
+ *   tagged with the current epoch; the epoch advances once every active reader has observed it, and a
+ *   node retired in epoch e is freed once the global epoch reaches e + 2.
+ * - Fallback: a reader stalled inside a guard stops the epoch, so limbo would grow without bound. Once a
+ *   thread's limbo reaches kEpochHazardScanThreshold, it frees every retired node that no active reader
+ *   has in a hazard slot. Pending nodes per thread therefore stay below threshold + batch + hazard slots.
+ *
+ * Contract: every shared pointer a reader dereferences must come from protect(), and only the most recent
+ * pointer per slot is protected. Nested guards share the thread's slots.
+ */
+
+constexpr std::size_t kEpochHazardSlots = 4;
+constexpr std::size_t kEpochReclaimBatch = 64;          // Retires between reclamation attempts
+constexpr std::size_t kEpochHazardScanThreshold = 1024; // Pending retires that trigger the hazard scan
+
+struct EpochRetired {
+    void* object;
+    void (*deleter)(void*);
+    std::uint64_t epoch;
+};
+
+struct alignas(64) EpochThreadRecord {
+    std::atomic<std::uint64_t> epoch{0}; // Epoch observed at guard entry; 0 outside guards
+    std::atomic<void*> hazards[kEpochHazardSlots] = {};
+    std::atomic<bool> inUse{false};
+    EpochThreadRecord* next = nullptr; // Immutable once published
+
+    // Owner-only state; the counters are read by epochStats().
+    unsigned nesting = 0;
+    std::vector<EpochRetired> limbo;
+    std::size_t nextReclaim = kEpochReclaimBatch;
+    std::atomic<std::uint64_t> retired{0};
+    std::atomic<std::uint64_t> freedByEpoch{0};
+    std::atomic<std::uint64_t> freedByHazardScan{0};
+    std::atomic<std::uint64_t> hazardScans{0};
+};
+
+struct EpochOrphans {
+    std::mutex mutex;
+    std::vector<EpochRetired> retired; // Limbo handed over by exited threads
+    std::atomic<bool> pending{false};
+};
+
+// Starts at 1 so that 0 can mean "not in a guard".
+std::atomic<std::uint64_t> epochGlobal{1};
+std::atomic<EpochThreadRecord*> epochThreads{nullptr};
+std::atomic<std::uint64_t> epochFenceCell{0};
+// Stored once, inside epochInitFences()'s static initializer. Every thread that fences has called
+// epochInitFences() first, so the initializer's completion orders the store before its relaxed loads.
+std::atomic<bool> epochAsymmetricFences{false};
+
+thread_local EpochThreadRecord* epochThreadRecord = nullptr;
+thread_local bool epochThreadExited = false;
+
+// Never destroyed: exiting threads hand their limbo over during program exit.
+EpochOrphans& epochOrphans() {
+    static EpochOrphans* orphans = new EpochOrphans();
+    return *orphans;
+}
+
+/*
+ * Function: epochInitFences()
+ *
+ * Purpose: Register for expedited membarrier once; without it, both sides fall back to full fences.
+ */
+bool epochInitFences() {
+#if EPOCHRECLAMATION_HAS_MEMBARRIER
+    static const bool registered = [] {
+        const bool ok = syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+        epochAsymmetricFences.store(ok, std::memory_order_relaxed);
+        return ok;
+    }();
+    return registered;
+#else
+    return false;
+#endif
+}
+
+// Reader side: orders the record store before the loads that follow it.
+void epochLightFence() {
+#if EPOCHRECLAMATION_TSAN
+    epochFenceCell.fetch_add(0, std::memory_order_seq_cst);
+#else
+    if (epochAsymmetricFences.load(std::memory_order_relaxed)) {
+        std::atomic_signal_fence(std::memory_order_seq_cst); // The reclaimer's membarrier does the rest
+    } else {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+#endif
+}
+
+// Reclaimer side: after this, every reader's earlier record stores are visible.
+void epochHeavyFence() {
+#if EPOCHRECLAMATION_TSAN
+    epochFenceCell.fetch_add(0, std::memory_order_seq_cst);
+#else
+#if EPOCHRECLAMATION_HAS_MEMBARRIER
+    if (epochInitFences()) { // Also covers a reclaimer that has never taken a thread record
+        syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+        return;
+    }
+#endif
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// Single writer: a relaxed load + store avoids a locked read-modify-write.
+void bumpEpochCounter(std::atomic<std::uint64_t>& counter, std::uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+// Section 2: Reclamation
+//------------------------------------------------------------------------------
+
+/*
+ * Function: tryAdvanceEpoch()
+ *
+ * Purpose: Move the global epoch forward by one if every thread inside a guard has observed it.
+ */
+bool tryAdvanceEpoch() {
+    std::uint64_t current = epochGlobal.load(std::memory_order_acquire);
+    epochHeavyFence();
+    for (EpochThreadRecord* r = epochThreads.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+        const std::uint64_t seen = r->epoch.load(std::memory_order_acquire);
+        if (seen != 0 && seen != current) {
+            return false; // A reader is still in the previous epoch
+        }
+    }
+    return epochGlobal.compare_exchange_strong(current, current + 1, std::memory_order_acq_rel);
+}
+
+// Free the entries retired two or more epochs ago; returns how many were freed.
+std::size_t freeEpochExpired(std::vector<EpochRetired>& list) {
+    const std::uint64_t epoch = epochGlobal.load(std::memory_order_acquire);
+    std::size_t kept = 0;
+    for (EpochRetired& entry : list) {
+        if (entry.epoch + 2 <= epoch) {
+            entry.deleter(entry.object);
+        } else {
+            list[kept++] = entry;
+        }
+    }
+    const std::size_t freed = list.size() - kept;
+    list.resize(kept);
+    return freed;
+}
+
+// Fallback: free every entry that no thread inside a guard has in a hazard slot.
+std::size_t freeUnprotected(std::vector<EpochRetired>& list) {
+    std::vector<void*> hazards;
+    epochHeavyFence();
+    for (EpochThreadRecord* r = epochThreads.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+        if (r->epoch.load(std::memory_order_acquire) == 0) {
+            continue; // Hazards outside a guard are stale
+        }
+        for (std::atomic<void*>& slot : r->hazards) {
+            if (void* hazard = slot.load(std::memory_order_acquire)) {
+                hazards.push_back(hazard);
+            }
+        }
+    }
+    std::sort(hazards.begin(), hazards.end());
+    std::size_t kept = 0;
+    for (EpochRetired& entry : list) {
+        if (std::binary_search(hazards.begin(), hazards.end(), entry.object)) {
+            list[kept++] = entry;
+        } else {
+            entry.deleter(entry.object);
+        }
+    }
+    const std::size_t freed = list.size() - kept;
+    list.resize(kept);
+    return freed;
+}
+
+// Run both passes over `list`, crediting `record`; the hazard scan only when the epoch is held back.
+void reclaimEpochList(EpochThreadRecord& record, std::vector<EpochRetired>& list) {
+    bumpEpochCounter(record.freedByEpoch, freeEpochExpired(list));
+    if (list.size() >= kEpochHazardScanThreshold) {
+        bumpEpochCounter(record.freedByHazardScan, freeUnprotected(list));
+        bumpEpochCounter(record.hazardScans, 1);
+    }
+}
+
+void reclaimEpochRecord(EpochThreadRecord& record) {
+    tryAdvanceEpoch();
+    reclaimEpochList(record, record.limbo);
+    EpochOrphans& orphans = epochOrphans();
+    if (orphans.pending.load(std::memory_order_relaxed)) {
+        std::unique_lock<std::mutex> lock(orphans.mutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            reclaimEpochList(record, orphans.retired);
+            orphans.pending.store(!orphans.retired.empty(), std::memory_order_relaxed);
+        }
+    }
+    record.nextReclaim = record.limbo.size() + kEpochReclaimBatch;
+}
+
+//------------------------------------------------------------------------------
+// Section 3: Thread Records
+//------------------------------------------------------------------------------
+
+struct EpochThreadRecordRelease {
+    ~EpochThreadRecordRelease() {
+        if (EpochThreadRecord* record = epochThreadRecord) {
+            reclaimEpochRecord(*record);
+            if (!record->limbo.empty()) {
+                EpochOrphans& orphans = epochOrphans();
+                std::lock_guard<std::mutex> lock(orphans.mutex);
+                orphans.retired.insert(orphans.retired.end(), record->limbo.begin(), record->limbo.end());
+                orphans.pending.store(true, std::memory_order_relaxed);
+                record->limbo.clear();
+            }
+            for (std::atomic<void*>& slot : record->hazards) {
+                slot.store(nullptr, std::memory_order_relaxed);
+            }
+            record->epoch.store(0, std::memory_order_release);
+            record->nesting = 0;
+            record->inUse.store(false, std::memory_order_release);
+        }
+        epochThreadRecord = nullptr;
+        epochThreadExited = true;
+    }
+};
+
+/*
+ * Function: acquireEpochThreadRecord()
+ *
+ * Purpose: Give the calling thread a record: one released by an exited thread or a new one. Records are
+ *          never freed, so reclaimers can walk the list without synchronization. A thread that needs a
+ *          record again from its own thread_local destructors keeps the new one for good.
+ */
+EpochThreadRecord* acquireEpochThreadRecord() {
+    epochInitFences();
+    EpochThreadRecord* record = nullptr;
+    for (EpochThreadRecord* r = epochThreads.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+        bool expected = false;
+        if (r->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            record = r;
+            break;
+        }
+    }
+    if (record == nullptr) {
+        record = new EpochThreadRecord();
+        record->inUse.store(true, std::memory_order_relaxed);
+        EpochThreadRecord* head = epochThreads.load(std::memory_order_relaxed);
+        do {
+            record->next = head;
+        } while (!epochThreads.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+    }
+    if (!epochThreadExited) {
+        static thread_local EpochThreadRecordRelease release; // Hands the record back at thread exit
+        (void)release;
+    }
+    epochThreadRecord = record;
+    return record;
+}
+
+EpochThreadRecord& currentEpochRecord() {
+    EpochThreadRecord* record = epochThreadRecord;
+    return record != nullptr ? *record : *acquireEpochThreadRecord();
+}
+
+//------------------------------------------------------------------------------
+// Section 4: Public API
+//------------------------------------------------------------------------------
+
+/*
+ * Class: EpochGuard
+ *
+ * Description: Read-side critical section. Entering costs a load of the global epoch and a store to the
+ *              thread's own record; protect() adds one store per pointer.
+ */
+class EpochGuard {
+public:
+    EpochGuard() : record_(currentEpochRecord()) {
+        if (record_.nesting++ == 0) {
+            record_.epoch.store(epochGlobal.load(std::memory_order_acquire), std::memory_order_release);
+            epochLightFence();
+        }
+    }
+
+    ~EpochGuard() {
+        if (--record_.nesting == 0) {
+            record_.epoch.store(0, std::memory_order_release);
+        }
+    }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+
+    // Load `source` and keep the result safe to dereference until `slot` is reused or the guard ends.
+    template <typename T>
+    T* protect(const std::atomic<T*>& source, std::size_t slot = 0) {
+        T* object = source.load(std::memory_order_acquire);
+        for (;;) {
+            record_.hazards[slot].store(object, std::memory_order_release);
+            epochLightFence();
+            T* again = source.load(std::memory_order_acquire);
+            if (again == object) {
+                return object;
+            }
+            object = again; // Changed before the hazard became visible: try again
+        }
+    }
+
+private:
+    EpochThreadRecord& record_;
+};
+
+/*
+ * Function: retire()
+ *
+ * Purpose: Hand an unlinked object to the reclaimer; `deleter` runs once no reader can still reach it.
+ */
+void retire(void* object, void (*deleter)(void*)) {
+    if (object == nullptr) {
+        return;
+    }
+    EpochThreadRecord& record = currentEpochRecord();
+    // A read-modify-write both reads the newest epoch and orders the caller's unlink before it.
+    const std::uint64_t epoch = epochGlobal.fetch_add(0, std::memory_order_seq_cst);
+    record.limbo.push_back({object, deleter, epoch});
+    bumpEpochCounter(record.retired, 1);
+    if (record.limbo.size() >= record.nextReclaim) {
+        reclaimEpochRecord(record);
+    }
+}
+
+template <typename T>
+void retire(T* object) {
+    retire(static_cast<void*>(object), [](void* p) { delete static_cast<T*>(p); });
+}
+
+/*
+ * Function: epochReclaimNow()
+ *
+ * Purpose: Advance the epoch as far as current readers allow and free what has become safe. Must not be
+ *          called inside a guard (the caller's own epoch would hold the advance back).
+ */
+void epochReclaimNow() {
+    EpochThreadRecord& record = currentEpochRecord();
+    for (int pass = 0; pass < 3; ++pass) {
+        reclaimEpochRecord(record);
+    }
+}
+
+struct EpochStats {
+    std::uint64_t epoch = 0;
+    std::uint64_t retired = 0;
+    std::uint64_t freedByEpoch = 0;
+    std::uint64_t freedByHazardScan = 0;
+    std::uint64_t hazardScans = 0;
+    std::uint64_t pending = 0;
+};
+
+EpochStats epochStats() {
+    EpochStats stats;
+    stats.epoch = epochGlobal.load(std::memory_order_relaxed);
+    for (EpochThreadRecord* r = epochThreads.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+        stats.retired += r->retired.load(std::memory_order_relaxed);
+        stats.freedByEpoch += r->freedByEpoch.load(std::memory_order_relaxed);
+        stats.freedByHazardScan += r->freedByHazardScan.load(std::memory_order_relaxed);
+        stats.hazardScans += r->hazardScans.load(std::memory_order_relaxed);
+    }
+    const std::uint64_t freed = stats.freedByEpoch + stats.freedByHazardScan;
+    stats.pending = stats.retired > freed ? stats.retired - freed : 0;
+    return stats;
+}
+
+//------------------------------------------------------------------------------
+// Section 5: Stress Test and Demonstration
+//------------------------------------------------------------------------------
+
+struct EpochStressNode {
+    std::uint64_t value;
+    std::uint64_t check; // ~value while the node is alive
+};
+
+constexpr std::uint64_t kEpochPoison = 0xDEADDEADDEADDEADull;
+
+void deleteEpochStressNode(void* p) {
+    EpochStressNode* node = static_cast<EpochStressNode*>(p);
+    node->check = kEpochPoison; // A reader that sees this read a freed node
+    delete node;
+}
+
+struct EpochStressResult {
+    std::uint64_t reads = 0;
+    std::uint64_t writes = 0;
+    std::uint64_t corruptReads = 0;
+    std::uint64_t maxPending = 0;
+    EpochStats stats;
+};
+
+/*
+ * Function: stressEpochReclamation()
+ *
+ * Purpose: Writers replace nodes in a small table and retire the old ones while readers verify every node
+ *          they protect. With `stallReader`, one extra thread sits in a guard (holding a hazard) for the
+ *          whole run, so only the hazard scan can free memory. Run a ThreadSanitizer build
+ *          (-DEPOCHRECLAMATION_TSAN=ON) to check the protocol for races.
+ */
+EpochStressResult stressEpochReclamation(int readers, int writers, std::chrono::milliseconds duration, bool stallReader) {
+    constexpr std::size_t kSlots = 8;
+    std::atomic<EpochStressNode*> table[kSlots];
+    for (std::size_t i = 0; i < kSlots; ++i) {
+        table[i].store(new EpochStressNode{i, ~std::uint64_t(i)}, std::memory_order_relaxed);
+    }
+    std::atomic<bool> stop{false};
+    std::atomic<bool> stalled{false};
+    std::atomic<std::uint64_t> reads{0}, writes{0}, corrupt{0};
+    const EpochStats before = epochStats();
+
+    std::vector<std::thread> threads;
+    if (stallReader) {
+        threads.emplace_back([&] {
+            EpochGuard guard;
+            EpochStressNode* held = guard.protect(table[0]);
+            stalled.store(true, std::memory_order_release);
+            while (!stop.load(std::memory_order_acquire)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1)); // Preempted reader
+            }
+            if (held->check != ~held->value) {
+                corrupt.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        while (!stalled.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            std::uint64_t count = 0, bad = 0;
+            std::size_t slot = static_cast<std::size_t>(r);
+            while (!stop.load(std::memory_order_relaxed)) {
+                EpochGuard guard;
+                for (int i = 0; i < 16; ++i, ++slot) {
+                    EpochStressNode* node = guard.protect(table[slot % kSlots]);
+                    bad += node->check != ~node->value;
+                }
+                count += 16;
+            }
+            reads.fetch_add(count, std::memory_order_relaxed);
+            corrupt.fetch_add(bad, std::memory_order_relaxed);
+        });
+    }
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w] {
+            std::uint64_t count = 0;
+            std::uint64_t value = static_cast<std::uint64_t>(w) << 48;
+            while (!stop.load(std::memory_order_relaxed)) {
+                ++value;
+                EpochStressNode* old = table[value % kSlots].exchange(new EpochStressNode{value, ~value}, std::memory_order_acq_rel);
+                retire(old, deleteEpochStressNode);
+                ++count;
+            }
+            writes.fetch_add(count, std::memory_order_relaxed);
+        });
+    }
+
+    std::uint64_t maxPending = 0;
+    const auto deadline = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        maxPending = std::max(maxPending, epochStats().pending);
+    }
+    stop.store(true, std::memory_order_release);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    for (std::atomic<EpochStressNode*>& slot : table) {
+        retire(slot.load(std::memory_order_relaxed), deleteEpochStressNode);
+    }
+    epochReclaimNow();
+
+    EpochStressResult result;
+    result.reads = reads.load();
+    result.writes = writes.load();
+    result.corruptReads = corrupt.load();
+    result.maxPending = maxPending;
+    result.stats = epochStats();
+    result.stats.retired -= before.retired;
+    result.stats.freedByEpoch -= before.freedByEpoch;
+    result.stats.freedByHazardScan -= before.freedByHazardScan;
+    result.stats.hazardScans -= before.hazardScans;
+    return result;
+}
+
+void printEpochStressResult(const char* label, const EpochStressResult& result) {
+    std::cout << label << ": " << result.reads << " reads, " << result.writes << " retires, "
+              << result.corruptReads << " corrupt reads\n"
+              << "  freed by epoch " << result.stats.freedByEpoch << ", by hazard scan " << result.stats.freedByHazardScan
+              << " (" << result.stats.hazardScans << " scans), max pending " << result.maxPending
+              << ", pending after drain " << result.stats.pending << "\n";
+}
+
+// Read-side cost of a guard + protect against weak_ptr::lock() on the same kind of shared slot.
+void benchmarkEpochReadCost(std::size_t iterations) {
+    EpochStressNode* node = new EpochStressNode{1, ~std::uint64_t(1)};
+    std::atomic<EpochStressNode*> slot{node};
+    std::uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        EpochGuard guard;
+        sum += guard.protect(slot)->value;
+    }
+    const double guardNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    std::shared_ptr<EpochStressNode> owner = std::make_shared<EpochStressNode>(EpochStressNode{1, ~std::uint64_t(1)});
+    std::weak_ptr<EpochStressNode> weak = owner;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        if (std::shared_ptr<EpochStressNode> locked = weak.lock()) {
+            sum += locked->value;
+        }
+    }
+    const double weakNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    retire(slot.load(), deleteEpochStressNode);
+    std::cout << "Read cost: EpochGuard + protect " << guardNs << " ns, weak_ptr::lock " << weakNs << " ns"
+              << (sum == 2 * iterations ? "" : " (checksum mismatch)") << "\n";
+}
+
+void runEpochReclamationExamples() {
+    std::cout << "\n--- Epoch-Based Reclamation with Hazard-Pointer Fallback ---\n";
+    std::cout << "Reader fences: " << (epochInitFences() ? "compiler-only (membarrier on the reclaim side)" : "full fences")
+              << "\n";
+    benchmarkEpochReadCost(10000000);
+    printEpochStressResult("2 readers, 1 writer", stressEpochReclamation(2, 1, std::chrono::milliseconds(300), false));
+    printEpochStressResult("2 readers, 1 writer, 1 stalled reader",
+                           stressEpochReclamation(2, 1, std::chrono::milliseconds(300), true));
+    std::cout << "Pending bound with a stalled reader: about " << kEpochHazardScanThreshold + kEpochReclaimBatch
+              << " nodes per writer plus one per hazard slot\n";
+}
+
+#endif // EPOCHRECLAMATION_H
@@ -0,0 +1,444 @@
+#ifndef HUGEPAGEALLOCATOR_H
+#define HUGEPAGEALLOCATOR_H
+
+#include <iostream>       // For standard input/output operations (cout, cerr)
+#include <fstream>        // For reading /proc/self/smaps and the sysfs node list
+#include <sstream>        // For parsing the online node list
+#include <string>         // For smaps lines
+#include <vector>         // For the scaled-up optimizeVectorAccess() benchmark
+#include <new>            // For std::bad_alloc and aligned ::operator new
+#include <type_traits>    // For std::true_type
+#include <utility>        // For std::swap
+#include <algorithm>      // For std::min/std::max
+#include <cstdint>        // For std::uintptr_t
+#include <cstddef>        // For std::size_t
+#include <cstring>        // For std::strerror
+#include <cerrno>         // For errno
+#include <chrono>         // For timing the benchmark
+#include <random>         // For random gather indices
+
+#include <sys/mman.h>     // For mmap(), munmap() and madvise()
+#include <unistd.h>       // For sysconf()
+
+// HUGEPAGEALLOCATOR_HAS_LIBNUMA is set by the build when libnuma is found; otherwise the raw system call
+// is used, with the policy constants taken from the kernel's own header so no libnuma package is needed.
+#if defined(__linux__) && defined(__has_include)
+#if defined(HUGEPAGEALLOCATOR_HAS_LIBNUMA) && __has_include(<numaif.h>)
+#include <numaif.h>            // For mbind() and the MPOL_* policy constants
+#define HUGEPAGEALLOCATOR_HAS_NUMAIF 1
+#elif __has_include(<linux/mempolicy.h>)
+#include <linux/mempolicy.h>   // For the MPOL_* policy constants (an enum, so not testable with #if)
+#include <sys/syscall.h>       // For SYS_mbind
+#define HUGEPAGEALLOCATOR_HAS_MEMPOLICY 1
+#endif
+#endif
+
+#if defined(HUGEPAGEALLOCATOR_HAS_NUMAIF) || (defined(HUGEPAGEALLOCATOR_HAS_MEMPOLICY) && defined(SYS_mbind))
+#define HUGEPAGEALLOCATOR_HAS_MBIND 1
+#else
+#define HUGEPAGEALLOCATOR_HAS_MBIND 0
+#endif
+
+#include "CodeOptimization.h" // For optimizeVectorAccess()
+
+//------------------------------------------------------------------------------
+// Section 1: Huge Pages, Alignment and NUMA Placement
+//------------------------------------------------------------------------------
+
+/*
+ * Why a dedicated allocator for big buffers?
+ * - TLB reach: with 4 KiB pages a 1536-entry second-level TLB covers only 6 MiB. A 256 MiB array walked
+ *   at random misses the TLB on almost every access, and each miss is a page walk. A 2 MiB page covers
+ *   512 times as much, so the same array needs only 128 entries.
+ * - Transparent huge pages (THP) are granted only to 2 MiB-aligned, 2 MiB-sized ranges of an anonymous
+ *   mapping, and only if the range is marked MADV_HUGEPAGE when the system is in "madvise" mode. malloc
+ *   and std::allocator give no such alignment, so they rarely get huge pages.
+ * - NUMA: on multi-socket machines pages are placed on the node of the thread that first touches them.
+ *   A buffer initialized by one thread and read by all is then remote for most of them; interleaving
+ *   spreads it over all nodes, binding pins it to one.
+ *
+ * Everything here degrades gracefully: if THP is disabled, madvise() fails or the kernel simply has no
+ * free huge pages, the buffer is backed by normal pages; if mbind() is unavailable or rejected, the
+ * default first-touch placement applies. LargeBufferStats reports what was actually granted, read back
+ * from /proc/self/smaps.
+ */
+
+const std::size_t kCacheLineBytes = 64;
+const std::size_t kHugePageBytes = 2 * 1024 * 1024;
+const std::size_t kHugePageMinMapBytes = 256 * 1024; // HugePageAllocator sends smaller requests to operator new
+
+enum class NumaPlacement {
+    FirstTouch, // Kernel default: each page on the node of the first thread to touch it (MPOL_LOCAL)
+    Interleave, // Round-robin over all online nodes (MPOL_INTERLEAVE)
+    Bind        // All pages on LargeBufferOptions::node (MPOL_BIND)
+};
+
+struct LargeBufferOptions {
+    std::size_t alignment = kHugePageBytes; // Power of two, at least kCacheLineBytes
+    bool hugePages = true;                  // Request THP with MADV_HUGEPAGE
+    NumaPlacement placement = NumaPlacement::FirstTouch;
+    int node = 0;                           // For NumaPlacement::Bind
+    bool prefault = false;                  // Touch every page now (on the calling thread's node)
+};
+
+struct LargeBufferStats {
+    std::size_t requestedBytes = 0;
+    std::size_t mappedBytes = 0;
+    std::size_t alignment = 0;
+    bool hugePagesRequested = false;
+    bool madviseAccepted = false; // The kernel accepted MADV_HUGEPAGE for the range
+    bool numaApplied = false;     // mbind() succeeded (always true for FirstTouch without mbind support)
+    int numaError = 0;            // errno from mbind(), 0 on success
+};
+
+// Size of the mapping backing a buffer of `bytes` (huge-page multiple when huge pages are requested).
+std::size_t largeBufferMappedBytes(std::size_t bytes, const LargeBufferOptions& options) {
+    const std::size_t granule = options.hugePages && bytes >= kHugePageBytes ? kHugePageBytes
+                                                                              : static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return (bytes + granule - 1) / granule * granule;
+}
+
+/*
+ * Function: onlineNumaNodeMask()
+ *
+ * Purpose: Bit mask of the online NUMA nodes (nodes 0-63) from /sys/devices/system/node/online,
+ *          e.g. "0" or "0-1,3". Machines without the file are treated as a single node 0.
+ */
+unsigned long onlineNumaNodeMask() {
+    std::ifstream in("/sys/devices/system/node/online");
+    std::string list;
+    if (!std::getline(in, list)) {
+        return 1;
+    }
+    unsigned long mask = 0;
+    std::istringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        const std::size_t dash = range.find('-');
+        const int first = std::stoi(range.substr(0, dash));
+        const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int n = first; n <= last && n < 64; ++n) {
+            mask |= 1ul << n;
+        }
+    }
+    return mask != 0 ? mask : 1;
+}
+
+// Apply the NUMA policy to [p, p + bytes). Returns 0 or an errno value.
+int applyNumaPlacement(void* p, std::size_t bytes, const LargeBufferOptions& options) {
+#if HUGEPAGEALLOCATOR_HAS_MBIND
+    unsigned long mask = 0;
+    int mode = MPOL_LOCAL;
+    if (options.placement == NumaPlacement::Interleave) {
+        mode = MPOL_INTERLEAVE;
+        mask = onlineNumaNodeMask();
+    } else if (options.placement == NumaPlacement::Bind) {
+        if (options.node < 0 || options.node >= 63) {
+            return EINVAL;
+        }
+        mode = MPOL_BIND;
+        mask = 1ul << options.node;
+    }
+    const unsigned long maxNode = mask != 0 ? sizeof(mask) * 8 : 0;
+#ifdef HUGEPAGEALLOCATOR_HAS_NUMAIF
+    const long result = mbind(p, bytes, mode, mask != 0 ? &mask : nullptr, maxNode, 0);
+#else
+    const long result = syscall(SYS_mbind, p, bytes, mode, mask != 0 ? &mask : nullptr, maxNode, 0);
+#endif
+    return result == 0 ? 0 : errno;
+#else
+    (void)p;
+    (void)bytes;
+    return options.placement == NumaPlacement::FirstTouch ? 0 : ENOSYS;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Section 2: Mapping and Inspecting Buffers
+//------------------------------------------------------------------------------
+
+/*
+ * Function: mapLargeBuffer()
+ *
+ * Purpose: Map at least `bytes` at `options.alignment`, request huge pages and apply the NUMA policy.
+ *          Policies are applied before the first touch, since pages are placed when they are faulted in.
+ *          Free with unmapLargeBuffer(p, bytes, options).
+ * Returns: nullptr if the mapping failed; `stats` (optional) describes what was granted.
+ */
+void* mapLargeBuffer(std::size_t bytes, const LargeBufferOptions& options, LargeBufferStats* stats = nullptr) {
+    const std::size_t alignment = options.alignment < kCacheLineBytes ? kCacheLineBytes : options.alignment;
+    if ((alignment & (alignment - 1)) != 0) {
+        std::cerr << "Error: Buffer alignment " << alignment << " is not a power of two.\n";
+        return nullptr;
+    }
+    const std::size_t mapped = largeBufferMappedBytes(bytes == 0 ? 1 : bytes, options);
+    const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const std::size_t slack = alignment > page ? alignment - page : 0;
+    void* raw = mmap(nullptr, mapped + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    // Trim the over-mapped head and tail so only the aligned range stays mapped.
+    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw);
+    const std::uintptr_t aligned = (start + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    if (aligned > start) {
+        munmap(raw, aligned - start);
+    }
+    if (start + mapped + slack > aligned + mapped) {
+        munmap(reinterpret_cast<void*>(aligned + mapped), start + mapped + slack - (aligned + mapped));
+    }
+    void* p = reinterpret_cast<void*>(aligned);
+
+    LargeBufferStats local;
+    local.requestedBytes = bytes;
+    local.mappedBytes = mapped;
+    local.alignment = alignment;
+    local.hugePagesRequested = options.hugePages && mapped >= kHugePageBytes;
+#ifdef MADV_HUGEPAGE
+    if (local.hugePagesRequested) {
+        local.madviseAccepted = madvise(p, mapped, MADV_HUGEPAGE) == 0; // EINVAL if THP is compiled out
+    }
+#endif
+    local.numaError = applyNumaPlacement(p, mapped, options);
+    local.numaApplied = local.numaError == 0;
+
+    if (options.prefault) {
+        for (std::size_t offset = 0; offset < mapped; offset += page) {
+            static_cast<volatile char*>(p)[offset] = 0;
+        }
+    }
+    if (stats != nullptr) {
+        *stats = local;
+    }
+    return p;
+}
+
+void unmapLargeBuffer(void* p, std::size_t bytes, const LargeBufferOptions& options) {
+    if (p != nullptr) {
+        munmap(p, largeBufferMappedBytes(bytes == 0 ? 1 : bytes, options));
+    }
+}
+
+/*
+ * Function: hugePageBytesGranted()
+ *
+ * Purpose: Bytes of [p, p + bytes) currently backed by transparent huge pages, summed from the
+ *          AnonHugePages field of every /proc/self/smaps mapping that overlaps the range. Only faulted-in
+ *          pages count, so call it after the buffer has been touched. Returns 0 where smaps is unavailable.
+ *
+ * Accuracy: smaps reports huge pages per mapping, not per address. Each mapping's count is clamped to
+ *           its overlap with the range, so the result never exceeds `bytes`. If a mapping extends past
+ *           the range (e.g. a std::vector inside a larger malloc arena), huge pages outside the range
+ *           can still be counted up to that overlap, so the result is an upper bound. It is exact for
+ *           LargeBuffer, whose range is a whole mapping of its own.
+ */
+std::size_t hugePageBytesGranted(const void* p, std::size_t bytes) {
+    std::ifstream smaps("/proc/self/smaps");
+    const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(p);
+    const std::uintptr_t end = begin + bytes;
+    std::size_t granted = 0;
+    std::size_t overlap = 0; // Bytes of the current mapping inside the range (0 if outside)
+    std::string line;
+    while (std::getline(smaps, line)) {
+        std::uintptr_t lo = 0, hi = 0;
+        char dash = 0;
+        std::istringstream fields(line);
+        if (fields >> std::hex >> lo >> dash >> hi && dash == '-') {
+            overlap = lo < end && hi > begin ? std::min(hi, end) - std::max(lo, begin) : 0; // Mapping header line
+            continue;
+        }
+        if (overlap != 0 && line.compare(0, 14, "AnonHugePages:") == 0) {
+            granted += std::min<std::size_t>(std::stoull(line.substr(14)) * 1024, overlap);
+        }
+    }
+    return std::min(granted, bytes);
+}
+
+//------------------------------------------------------------------------------
+// Section 3: LargeBuffer and HugePageAllocator<T>
+//------------------------------------------------------------------------------
+
+/*
+ * Class: LargeBuffer
+ *
+ * Description: RAII owner of one mapLargeBuffer() mapping. Move-only.
+ */
+class LargeBuffer {
+public:
+    LargeBuffer() = default;
+
+    explicit LargeBuffer(std::size_t bytes, const LargeBufferOptions& options = LargeBufferOptions())
+        : options_(options), stats_(), data_(mapLargeBuffer(bytes, options, &stats_)), bytes_(bytes) {
+        if (data_ == nullptr) {
+            std::cerr << "Error: Unable to map a " << bytes << "-byte buffer: " << std::strerror(errno) << "\n";
+        }
+    }
+
+    LargeBuffer(LargeBuffer&& other) noexcept { swap(other); }
+
+    LargeBuffer& operator=(LargeBuffer&& other) noexcept {
+        LargeBuffer(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    LargeBuffer(const LargeBuffer&) = delete;
+    LargeBuffer& operator=(const LargeBuffer&) = delete;
+
+    ~LargeBuffer() { unmapLargeBuffer(data_, bytes_, options_); }
+
+    void* data() const { return data_; }
+    std::size_t size() const { return bytes_; }
+    bool isOpen() const { return data_ != nullptr; }
+    explicit operator bool() const { return isOpen(); }
+
+    // Mapping details plus the huge-page bytes granted so far.
+    const LargeBufferStats& stats() const { return stats_; }
+    std::size_t hugePageBytes() const { return data_ != nullptr ? hugePageBytesGranted(data_, stats_.mappedBytes) : 0; }
+
+    void swap(LargeBuffer& other) noexcept {
+        std::swap(options_, other.options_);
+        std::swap(stats_, other.stats_);
+        std::swap(data_, other.data_);
+        std::swap(bytes_, other.bytes_);
+    }
+
+private:
+    LargeBufferOptions options_;
+    LargeBufferStats stats_; // Declared before data_: mapLargeBuffer() fills it during construction
+    void* data_ = nullptr;
+    std::size_t bytes_ = 0;
+};
+
+/*
+ * Class: HugePageAllocator<T>
+ *
+ * Description: Standard allocator for large arrays, e.g. std::vector<int, HugePageAllocator<int>>.
+ *              Requests of kHugePageMinMapBytes and more are mapped 2 MiB-aligned with MADV_HUGEPAGE;
+ *              smaller ones (a vector's first growth steps) come from cache-line-aligned operator new.
+ *              Stateless, default placement (first touch).
+ */
+template <typename T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    HugePageAllocator() noexcept = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t numObjects) {
+        if (numObjects > static_cast<std::size_t>(-1) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        const std::size_t bytes = numObjects * sizeof(T);
+        if (bytes < kHugePageMinMapBytes) {
+            return static_cast<T*>(::operator new(bytes, std::align_val_t(kCacheLineBytes)));
+        }
+        void* p = mapLargeBuffer(bytes, LargeBufferOptions());
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t numObjects) noexcept {
+        const std::size_t bytes = numObjects * sizeof(T);
+        if (bytes < kHugePageMinMapBytes) {
+            ::operator delete(p, std::align_val_t(kCacheLineBytes));
+        } else {
+            unmapLargeBuffer(p, bytes, LargeBufferOptions());
+        }
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const HugePageAllocator<T>&, const HugePageAllocator<U>&) noexcept { return true; }
+
+template <typename T, typename U>
+bool operator!=(const HugePageAllocator<T>&, const HugePageAllocator<U>&) noexcept { return false; }
+
+//------------------------------------------------------------------------------
+// Section 4: Benchmark and Demonstration
+//------------------------------------------------------------------------------
+
+// Random gather over the whole array: one TLB lookup per access, mostly misses with 4 KiB pages.
+template <typename Vector>
+double randomGatherNsPerAccess(const Vector& v, const std::vector<std::uint32_t>& indices, long long& sink) {
+    const auto start = std::chrono::steady_clock::now();
+    long long sum = 0;
+    for (std::uint32_t i : indices) {
+        sum += v[i];
+    }
+    sink += sum;
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / indices.size();
+}
+
+/*
+ * Function: benchmarkHugePageVector()
+ *
+ * Purpose: Scale optimizeVectorAccess() up to `elements` ints and compare std::allocator with
+ *          HugePageAllocator: first-touch construction, the sequential pass and a random gather.
+ */
+void benchmarkHugePageVector(std::size_t elements) {
+    using Clock = std::chrono::steady_clock;
+    std::mt19937 gen(7);
+    std::vector<std::uint32_t> indices(4000000);
+    for (std::uint32_t& i : indices) {
+        i = static_cast<std::uint32_t>(gen() % elements);
+    }
+    long long sink = 0;
+
+    auto run = [&](auto& v, const char* label) {
+        auto start = Clock::now();
+        v.assign(elements, 1); // First touch: page faults happen here
+        const double fillMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        start = Clock::now();
+        optimizeVectorAccess(v);
+        const double passMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        const double gatherNs = randomGatherNsPerAccess(v, indices, sink);
+        std::cout << "  " << label << ": fill " << fillMs << " ms, optimizeVectorAccess " << passMs
+                  << " ms, random gather " << gatherNs << " ns/access, huge pages "
+                  << hugePageBytesGranted(v.data(), v.size() * sizeof(int)) / (1024 * 1024) << " MiB\n";
+    };
+
+    std::cout << elements * sizeof(int) / (1024 * 1024) << " MiB of int:\n";
+    {
+        std::vector<int> plain;
+        run(plain, "std::allocator   ");
+    }
+    {
+        std::vector<int, HugePageAllocator<int>> huge;
+        run(huge, "HugePageAllocator");
+    }
+    std::cout << "  (gather checksum " << sink << ")\n";
+}
+
+void runHugePageAllocatorExamples() {
+    std::cout << "\n--- Huge-Page and NUMA-Aware Buffers ---\n";
+    std::cout << "Online NUMA node mask: 0x" << std::hex << onlineNumaNodeMask() << std::dec
+              << (HUGEPAGEALLOCATOR_HAS_MBIND ? ", mbind available" : ", mbind unavailable") << "\n";
+
+    for (NumaPlacement placement : {NumaPlacement::FirstTouch, NumaPlacement::Interleave, NumaPlacement::Bind}) {
+        LargeBufferOptions options;
+        options.placement = placement;
+        options.prefault = true;
+        LargeBuffer buffer(32 * 1024 * 1024, options);
+        if (!buffer) {
+            continue;
+        }
+        const LargeBufferStats& s = buffer.stats();
+        const char* name = placement == NumaPlacement::FirstTouch ? "first-touch"
+                         : placement == NumaPlacement::Interleave ? "interleave " : "bind node 0";
+        std::cout << name << ": " << s.mappedBytes / (1024 * 1024) << " MiB at "
+                  << (reinterpret_cast<std::uintptr_t>(buffer.data()) % kHugePageBytes == 0 ? "2 MiB" : "page")
+                  << " alignment, MADV_HUGEPAGE " << (s.madviseAccepted ? "accepted" : "rejected")
+                  << ", huge pages granted " << buffer.hugePageBytes() / (1024 * 1024) << " MiB, NUMA policy "
+                  << (s.numaApplied ? "applied" : std::strerror(s.numaError)) << "\n";
+    }
+
+    benchmarkHugePageVector(64 * 1024 * 1024);
+}
+
+#endif // HUGEPAGEALLOCATOR_H
@@ -0,0 +1,407 @@
+#ifndef INTRUSIVEPTR_H
+#define INTRUSIVEPTR_H
+
+#include <iostream>       // For standard input/output operations (cout)
+#include <memory>         // For shared_ptr in the comparison benchmark
+#include <atomic>         // For the atomic counting policy
+#include <thread>         // For std::this_thread::yield in the weak-block lock
+#include <vector>         // For the benchmarks
+#include <utility>        // For std::forward, std::swap
+#include <cstdint>        // For std::uint32_t
+#include <cstddef>        // For std::size_t
+#include <chrono>         // For timing the benchmarks
+
+//------------------------------------------------------------------------------
+// Section 1: Counting Policies
+//------------------------------------------------------------------------------
+
+/*
+ * Why an intrusive pointer?
+ * - std::shared_ptr keeps its counts in a separate control block (fused with the object by make_shared,
+ *   but still 16 extra bytes), is itself two pointers wide, and in a program linked with the thread
+ *   library counts with atomic instructions even when the object never leaves its thread.
+ * - intrusive_ptr<T> is one pointer wide and keeps the count inside T (T derives from RefCounted<Policy>).
+ *   The Policy decides at compile time how the count is updated:
+ *     - NonAtomicRefCount: plain increments, for objects confined to one thread.
+ *     - AtomicRefCount: relaxed increments and release/acquire decrements, for shared objects.
+ * - Weak references are rare, so their cost is paid only when used: the first intrusive_weak_ptr creates
+ *   a small side block that records whether the object is still alive. Objects that are never weakly
+ *   referenced carry just a null pointer.
+ *
+ * Upgrading a weak reference (lock()) and releasing the last strong one both take the side block's lock,
+ * so lock() never touches the count of an object that is being destroyed.
+ */
+
+struct NonAtomicRefCount {
+    template <typename U>
+    using Cell = U;
+
+    template <typename U>
+    static U load(const Cell<U>& cell) { return cell; }
+    template <typename U>
+    static void store(Cell<U>& cell, U value) { cell = value; }
+
+    static void increment(Cell<std::uint32_t>& count) { ++count; }
+    // True when the count dropped to zero.
+    static bool decrement(Cell<std::uint32_t>& count) { return --count == 0; }
+    static bool incrementIfNonZero(Cell<std::uint32_t>& count) {
+        if (count == 0) return false;
+        ++count;
+        return true;
+    }
+    // Set `cell` to `value` if it is still null.
+    template <typename U>
+    static bool install(Cell<U*>& cell, U* value) {
+        if (cell != nullptr) return false;
+        cell = value;
+        return true;
+    }
+
+    struct Guard {
+        explicit Guard(Cell<bool>&) {}
+    };
+};
+
+struct AtomicRefCount {
+    template <typename U>
+    using Cell = std::atomic<U>;
+
+    template <typename U>
+    static U load(const Cell<U>& cell) { return cell.load(std::memory_order_acquire); }
+    template <typename U>
+    static void store(Cell<U>& cell, U value) { cell.store(value, std::memory_order_release); }
+
+    // A new reference is always made from an existing one, so no ordering is needed.
+    static void increment(Cell<std::uint32_t>& count) { count.fetch_add(1, std::memory_order_relaxed); }
+    // Release publishes this owner's writes; acquire makes every owner's writes visible to the destroyer.
+    static bool decrement(Cell<std::uint32_t>& count) {
+        return count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+    static bool incrementIfNonZero(Cell<std::uint32_t>& count) {
+        std::uint32_t current = count.load(std::memory_order_relaxed);
+        while (current != 0) {
+            if (count.compare_exchange_weak(current, current + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    template <typename U>
+    static bool install(Cell<U*>& cell, U* value) {
+        U* expected = nullptr;
+        return cell.compare_exchange_strong(expected, value, std::memory_order_acq_rel);
+    }
+
+    // Spin lock for the side block; held only for a few instructions.
+    struct Guard {
+        explicit Guard(Cell<bool>& flag) : flag_(flag) {
+            while (flag_.exchange(true, std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+        ~Guard() { flag_.store(false, std::memory_order_release); }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        Cell<bool>& flag_;
+    };
+};
+
+//------------------------------------------------------------------------------
+// Section 2: RefCounted Base, intrusive_ptr and intrusive_weak_ptr
+//------------------------------------------------------------------------------
+
+template <typename Policy>
+class RefCounted;
+
+template <typename Policy>
+struct IntrusiveWeakBlock {
+    typename Policy::template Cell<std::uint32_t> refs{1};             // Weak pointers + 1 while the object lives
+    typename Policy::template Cell<RefCounted<Policy>*> object{nullptr}; // Cleared when the object dies
+    typename Policy::template Cell<bool> lock{false};
+
+    explicit IntrusiveWeakBlock(RefCounted<Policy>* target) : object(target) {}
+
+    void release() {
+        if (Policy::decrement(refs)) delete this;
+    }
+};
+
+/*
+ * Class: RefCounted<Policy>
+ *
+ * Description: Base class carrying the embedded count (and the lazily created weak block) for
+ *              intrusive_ptr. Copying an object does not copy its count.
+ */
+template <typename Policy>
+class RefCounted {
+public:
+    using RefCountPolicy = Policy;
+
+    std::uint32_t useCount() const { return Policy::load(refs_); }
+    bool hasWeakBlock() const { return Policy::load(weak_) != nullptr; }
+
+protected:
+    RefCounted() = default;
+    RefCounted(const RefCounted&) : RefCounted() {}
+    RefCounted& operator=(const RefCounted&) { return *this; }
+    ~RefCounted() = default;
+
+private:
+    template <typename, typename> friend class intrusive_ptr;
+    template <typename, typename> friend class intrusive_weak_ptr;
+
+    // The weak block shared by all weak pointers to this object, created on first request.
+    IntrusiveWeakBlock<Policy>* weakBlock() {
+        IntrusiveWeakBlock<Policy>* block = Policy::load(weak_);
+        if (block == nullptr) {
+            IntrusiveWeakBlock<Policy>* created = new IntrusiveWeakBlock<Policy>(this);
+            if (Policy::install(weak_, created)) {
+                block = created;
+            } else {
+                delete created; // Another thread installed one first
+                block = Policy::load(weak_);
+            }
+        }
+        return block;
+    }
+
+    // Called with the count at zero, before the object is deleted.
+    void detachWeakBlock() {
+        if (IntrusiveWeakBlock<Policy>* block = Policy::load(weak_)) {
+            {
+                typename Policy::Guard guard(block->lock);
+                Policy::store(block->object, static_cast<RefCounted*>(nullptr));
+            }
+            block->release();
+        }
+    }
+
+    mutable typename Policy::template Cell<std::uint32_t> refs_{0};
+    typename Policy::template Cell<IntrusiveWeakBlock<Policy>*> weak_{nullptr};
+};
+
+/*
+ * Class: intrusive_ptr<T, Policy>
+ *
+ * Description: Shared ownership of a T derived from RefCounted<Policy>, one pointer wide.
+ *              The last owner deletes the object through T*, so T must be the dynamic type or have a
+ *              virtual destructor.
+ */
+template <typename T, typename Policy = typename T::RefCountPolicy>
+class intrusive_ptr {
+public:
+    intrusive_ptr() = default;
+
+    explicit intrusive_ptr(T* object) : object_(object) {
+        if (object_ != nullptr) Policy::increment(base()->refs_);
+    }
+
+    intrusive_ptr(const intrusive_ptr& other) : object_(other.object_) {
+        if (object_ != nullptr) Policy::increment(base()->refs_);
+    }
+
+    intrusive_ptr(intrusive_ptr&& other) noexcept : object_(other.object_) { other.object_ = nullptr; }
+
+    intrusive_ptr& operator=(intrusive_ptr other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~intrusive_ptr() { reset(); }
+
+    void reset() {
+        if (object_ != nullptr && Policy::decrement(base()->refs_)) {
+            base()->detachWeakBlock();
+            delete object_;
+        }
+        object_ = nullptr;
+    }
+
+    void swap(intrusive_ptr& other) noexcept { std::swap(object_, other.object_); }
+
+    T* get() const { return object_; }
+    T& operator*() const { return *object_; }
+    T* operator->() const { return object_; }
+    explicit operator bool() const { return object_ != nullptr; }
+    std::uint32_t use_count() const { return object_ != nullptr ? object_->useCount() : 0; }
+
+    bool operator==(const intrusive_ptr& other) const { return object_ == other.object_; }
+    bool operator!=(const intrusive_ptr& other) const { return object_ != other.object_; }
+
+private:
+    template <typename, typename> friend class intrusive_weak_ptr;
+
+    struct AdoptTag {};
+    intrusive_ptr(T* object, AdoptTag) : object_(object) {} // Takes over a reference already counted
+
+    RefCounted<Policy>* base() const { return object_; }
+
+    T* object_ = nullptr;
+};
+
+template <typename T, typename... Args>
+intrusive_ptr<T> make_intrusive(Args&&... args) {
+    return intrusive_ptr<T>(new T(std::forward<Args>(args)...));
+}
+
+/*
+ * Class: intrusive_weak_ptr<T, Policy>
+ *
+ * Description: Non-owning reference; lock() yields an intrusive_ptr while the object is alive.
+ */
+template <typename T, typename Policy = typename T::RefCountPolicy>
+class intrusive_weak_ptr {
+public:
+    intrusive_weak_ptr() = default;
+
+    intrusive_weak_ptr(const intrusive_ptr<T, Policy>& strong) {
+        if (strong) {
+            block_ = static_cast<RefCounted<Policy>*>(strong.get())->weakBlock();
+            Policy::increment(block_->refs);
+        }
+    }
+
+    intrusive_weak_ptr(const intrusive_weak_ptr& other) : block_(other.block_) {
+        if (block_ != nullptr) Policy::increment(block_->refs);
+    }
+
+    intrusive_weak_ptr(intrusive_weak_ptr&& other) noexcept : block_(other.block_) { other.block_ = nullptr; }
+
+    intrusive_weak_ptr& operator=(intrusive_weak_ptr other) noexcept {
+        std::swap(block_, other.block_);
+        return *this;
+    }
+
+    ~intrusive_weak_ptr() {
+        if (block_ != nullptr) block_->release();
+    }
+
+    intrusive_ptr<T, Policy> lock() const {
+        if (block_ == nullptr) {
+            return intrusive_ptr<T, Policy>();
+        }
+        typename Policy::Guard guard(block_->lock);
+        RefCounted<Policy>* object = Policy::load(block_->object);
+        if (object == nullptr || !Policy::incrementIfNonZero(object->refs_)) {
+            return intrusive_ptr<T, Policy>();
+        }
+        return intrusive_ptr<T, Policy>(static_cast<T*>(object), typename intrusive_ptr<T, Policy>::AdoptTag());
+    }
+
+    bool expired() const { return block_ == nullptr || Policy::load(block_->object) == nullptr; }
+
+private:
+    IntrusiveWeakBlock<Policy>* block_ = nullptr;
+};
+
+//------------------------------------------------------------------------------
+// Section 3: Benchmarks Against shared_ptr
+//------------------------------------------------------------------------------
+
+struct SharedCounter {
+    std::uint64_t value = 0;
+};
+
+template <typename Policy>
+struct IntrusiveCounter : RefCounted<Policy> {
+    std::uint64_t value = 0;
+};
+
+/*
+ * Function: pointerCopyDestroyNs()
+ *
+ * Purpose: Copy every pointer of `owners` into a second vector and destroy the copies, `rounds` times;
+ *          nanoseconds per copy + destroy pair.
+ */
+template <typename Pointer>
+double pointerCopyDestroyNs(const std::vector<Pointer>& owners, int rounds) {
+    std::vector<Pointer> copies;
+    copies.reserve(owners.size());
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const Pointer& p : owners) copies.push_back(p);
+        copies.clear();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+           (static_cast<double>(owners.size()) * rounds);
+}
+
+template <typename Make>
+double pointerCreateDestroyNs(std::size_t count, Make make) {
+    const auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<decltype(make())> owners;
+        owners.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) owners.push_back(make());
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+void benchmarkIntrusivePtr(std::size_t count) {
+    std::vector<std::shared_ptr<SharedCounter>> shared;
+    std::vector<intrusive_ptr<IntrusiveCounter<AtomicRefCount>>> atomic;
+    std::vector<intrusive_ptr<IntrusiveCounter<NonAtomicRefCount>>> plain;
+    for (std::size_t i = 0; i < count; ++i) {
+        shared.push_back(std::make_shared<SharedCounter>());
+        atomic.push_back(make_intrusive<IntrusiveCounter<AtomicRefCount>>());
+        plain.push_back(make_intrusive<IntrusiveCounter<NonAtomicRefCount>>());
+    }
+    const int rounds = 20;
+    std::cout << count << " objects, copy + destroy per pointer:\n"
+              << "  shared_ptr                  " << pointerCopyDestroyNs(shared, rounds) << " ns\n"
+              << "  intrusive_ptr (atomic)      " << pointerCopyDestroyNs(atomic, rounds) << " ns\n"
+              << "  intrusive_ptr (non-atomic)  " << pointerCopyDestroyNs(plain, rounds) << " ns\n";
+    std::cout << "Create + destroy per object:\n"
+              << "  make_shared                 "
+              << pointerCreateDestroyNs(count, [] { return std::make_shared<SharedCounter>(); }) << " ns\n"
+              << "  make_intrusive (atomic)     "
+              << pointerCreateDestroyNs(count, [] { return make_intrusive<IntrusiveCounter<AtomicRefCount>>(); }) << " ns\n"
+              << "  make_intrusive (non-atomic) "
+              << pointerCreateDestroyNs(count, [] { return make_intrusive<IntrusiveCounter<NonAtomicRefCount>>(); }) << " ns\n";
+
+    // make_shared allocates a 16-byte control block (vtable pointer + two 32-bit counts) with the object.
+    std::cout << "Memory for an 8-byte payload: shared_ptr " << 16 + sizeof(SharedCounter) << " bytes/object + "
+              << sizeof(std::shared_ptr<SharedCounter>) << " bytes/pointer, intrusive_ptr "
+              << sizeof(IntrusiveCounter<AtomicRefCount>) << " bytes/object + "
+              << sizeof(intrusive_ptr<IntrusiveCounter<AtomicRefCount>>) << " bytes/pointer (weak block "
+              << sizeof(IntrusiveWeakBlock<AtomicRefCount>) << " bytes, only once weakly referenced)\n";
+}
+
+//------------------------------------------------------------------------------
+// Section 4: Demonstration
+//------------------------------------------------------------------------------
+
+// demoSmartPointers() with an intrusive count: a single-threaded object announcing its lifetime.
+class IntrusiveGreeter : public RefCounted<NonAtomicRefCount> {
+public:
+    IntrusiveGreeter() { std::cout << "IntrusiveGreeter object created\n"; }
+    ~IntrusiveGreeter() { std::cout << "IntrusiveGreeter object destroyed\n"; }
+    void greet() const { std::cout << "Hello from IntrusiveGreeter\n"; }
+};
+
+void runIntrusivePtrExamples() {
+    std::cout << "\n--- intrusive_ptr: Embedded Reference Count ---\n";
+    intrusive_ptr<IntrusiveGreeter> first = make_intrusive<IntrusiveGreeter>();
+    intrusive_ptr<IntrusiveGreeter> second = first;
+    first->greet();
+    std::cout << "use_count: " << first.use_count() << ", weak block allocated: " << std::boolalpha
+              << first->hasWeakBlock() << "\n";
+
+    intrusive_weak_ptr<IntrusiveGreeter> observer = first;
+    std::cout << "After taking a weak reference, weak block allocated: " << first->hasWeakBlock() << "\n";
+    if (auto locked = observer.lock()) {
+        std::cout << "Weak pointer locked, use_count: " << locked.use_count() << "\n";
+    }
+
+    first.reset();
+    std::cout << "After first.reset(), use_count: " << second.use_count() << "\n";
+    second.reset(); // Last owner: the object is destroyed here
+    std::cout << "Weak pointer expired: " << observer.expired() << ", lock() "
+              << (observer.lock() ? "succeeded" : "returned null") << std::noboolalpha << "\n\n";
+
+    benchmarkIntrusivePtr(1000000);
+}
+
+#endif // INTRUSIVEPTR_H
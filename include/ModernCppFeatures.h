@@ -7,6 +7,7 @@
 #include <algorithm>      // For standard algorithms (e.g., std::for_each)
 #include <functional>     // For std::function (used with lambdas)
 #include <string_view>    // Lightweight string representation for better performance
+#include "PoolAllocator.h" // For make_pooled_shared
 
 // ----------------------------------------------------------------------------
 // Section 1: Type Inference with 'auto' (C++11)
@@ -89,6 +90,8 @@ void demonstrateLambdas() {
  *   - Shared Pointers (shared_ptr):  Allow multiple owners of a resource (reference counted).
  *     Resource is deleted when the last shared_ptr pointing to it is destroyed.
  *     std::make_shared is preferred for creating shared_ptrs due to exception safety.
+ *     make_pooled_shared (PoolAllocator.h) does the same via std::allocate_shared, drawing the fused
+ *     object + control block from a pool instead of the global heap.
  *
  *   - Unique Pointers (unique_ptr): Only one unique_ptr can own a resource.
  *     The resource is deleted when the unique_ptr goes out of scope.
@@ -102,7 +105,7 @@ void demonstrateSmartPointers() {
     std::unique_ptr<MyClass> uniquePtr(new MyClass()); // create a unique pointer
     uniquePtr->greet();
 
-    std::shared_ptr<MyClass> sharedPtr1 = std::make_shared<MyClass>(); // create a shared pointer
+    std::shared_ptr<MyClass> sharedPtr1 = make_pooled_shared<MyClass>(); // create a shared pointer (pooled allocation)
     sharedPtr1->greet();
 
     std::shared_ptr<MyClass> sharedPtr2 = sharedPtr1;  // Both pointers manage the same object
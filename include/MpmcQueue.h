@@ -0,0 +1,505 @@
+#ifndef MPMCQUEUE_H
+#define MPMCQUEUE_H
+
+#include <iostream>       // For standard input/output operations (cout)
+#include <atomic>         // For cell sequences, positions and futex words
+#include <thread>         // For std::this_thread::yield and the benchmark threads
+#include <mutex>          // For the locked baseline queue
+#include <condition_variable> // For the locked baseline queue
+#include <queue>          // For the locked baseline queue
+#include <vector>         // For the benchmark threads
+#include <string>         // For the benchmark labels
+#include <memory>         // For the cell array
+#include <new>            // For placement new
+#include <type_traits>    // For std::aligned_storage
+#include <utility>        // For std::move, std::forward
+#include <algorithm>      // For std::min
+#include <climits>        // For INT_MAX (wake all)
+#include <cstdint>        // For std::uint32_t, std::intptr_t
+#include <cstddef>        // For std::size_t
+#include <chrono>         // For timing the benchmark
+#include "CpuFeatures.h"  // For cpuRelax
+
+#if __has_include(<linux/futex.h>) && __has_include(<sys/syscall.h>)
+#include <linux/futex.h>  // For FUTEX_WAIT_PRIVATE / FUTEX_WAKE_PRIVATE
+#include <sys/syscall.h>  // For SYS_futex
+#include <unistd.h>       // For syscall
+#define MPMCQUEUE_HAS_FUTEX 1
+#else
+#define MPMCQUEUE_HAS_FUTEX 0
+#endif
+
+// ThreadSanitizer does not model stand-alone fences, so sanitized builds use a read-modify-write instead.
+#if defined(__SANITIZE_THREAD__)
+#define MPMCQUEUE_TSAN 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define MPMCQUEUE_TSAN 1
+#endif
+#endif
+#ifndef MPMCQUEUE_TSAN
+#define MPMCQUEUE_TSAN 0
+#endif
+
+//------------------------------------------------------------------------------
+// Section 1: FutexEvent - Parking Without a Mutex
+//------------------------------------------------------------------------------
+
+/*
+ * Class: FutexEvent
+ *
+ * Description: Lets threads sleep until some lock-free condition may have changed.
+ *              Waiter:   ticket = prepareWait(); re-check the condition; then cancelWait() or wait(ticket).
+ *              Notifier: change the state, then notify(). The notifier only makes a system call when
+ *              somebody is registered as waiting, so the uncontended path is a fence and a load.
+ *              Without futex support, wait() degrades to a short sleep (polling).
+ */
+class FutexEvent {
+public:
+    std::uint32_t prepareWait() {
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        return sequence_.load(std::memory_order_acquire);
+    }
+
+    void cancelWait() { waiters_.fetch_sub(1, std::memory_order_relaxed); }
+
+    // Returns when notified, or at once if a notification arrived after prepareWait().
+    void wait(std::uint32_t ticket) {
+#if MPMCQUEUE_HAS_FUTEX
+        static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex word must be 32 bits");
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&sequence_), FUTEX_WAIT_PRIVATE, ticket, nullptr, nullptr, 0);
+#else
+        if (sequence_.load(std::memory_order_acquire) == ticket) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+#endif
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify(int count = 1) {
+        // Orders the caller's state change before the waiters_ check; pairs with prepareWait().
+#if MPMCQUEUE_TSAN
+        waiters_.fetch_add(0, std::memory_order_seq_cst);
+#else
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+        if (waiters_.load(std::memory_order_seq_cst) > 0) {
+            wake(count);
+        }
+    }
+
+    void notifyAll() { wake(INT_MAX); }
+
+private:
+    void wake(int count) {
+        sequence_.fetch_add(1, std::memory_order_release);
+#if MPMCQUEUE_HAS_FUTEX
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&sequence_), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#else
+        (void)count;
+#endif
+    }
+
+    std::atomic<std::uint32_t> sequence_{0};
+    std::atomic<int> waiters_{0};
+};
+
+//------------------------------------------------------------------------------
+// Section 2: MpmcQueue<T> - Bounded Lock-Free Ring (Vyukov)
+//------------------------------------------------------------------------------
+
+/*
+ * Why a lock-free ring?
+ * - A std::queue behind one mutex serializes every push and pop, and each notify_one() can cost a
+ *   context switch. Under contention the lock, not the work, sets the throughput.
+ * - Dmitry Vyukov's bounded MPMC queue gives every cell a sequence number:
+ *     - cell.sequence == pos      : free for the producer that claims position pos
+ *     - cell.sequence == pos + 1  : holds the item for the consumer that claims position pos
+ *   Producers and consumers claim positions with one CAS on separate counters (on separate cache lines),
+ *   then publish through the cell's sequence, so a producer and a consumer never touch the same
+ *   counter and an empty or full queue is detected without any lock.
+ * - Blocking push()/pop() spin briefly (cheap if the other side is running on another core), then
+ *   yield, then park on a FutexEvent; notifications cost a system call only when a thread is parked.
+ * - close() wakes everybody: push() then fails, pop() drains what is left and then fails. The closed
+ *   flag is the top bit of the enqueue counter, so close() and a producer's claim are ordered by that
+ *   one atomic: a claim either happens before close() (and pop() waits for the item to be published
+ *   before reporting the queue drained) or fails. A push() racing close() is never lost.
+ */
+const int kMpmcSpinRounds = 64;
+const int kMpmcYieldRounds = 16;
+
+template <typename T>
+class MpmcQueue {
+public:
+    // Capacity is rounded up to a power of two (at least 2).
+    explicit MpmcQueue(std::size_t capacity) {
+        std::size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded *= 2;
+        }
+        mask_ = rounded - 1;
+        cells_.reset(new Cell[rounded]);
+        for (std::size_t i = 0; i < rounded; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpmcQueue() {
+        const std::size_t tail = enqueuePos_.load(std::memory_order_relaxed) & ~kClosedBit;
+        for (std::size_t pos = dequeuePos_.load(std::memory_order_relaxed); pos != tail; ++pos) {
+            reinterpret_cast<T*>(&cells_[pos & mask_].storage)->~T();
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    template <typename U>
+    bool try_push(U&& value) {
+        if (!tryEnqueue(std::forward<U>(value))) {
+            return false;
+        }
+        notEmpty_.notify();
+        return true;
+    }
+
+    bool try_pop(T& out) {
+        if (!tryDequeue(out)) {
+            return false;
+        }
+        notFull_.notify();
+        return true;
+    }
+
+    // Batch forms: copy in the first k of `count` items that fit (or pop up to `maxCount`), notify once.
+    std::size_t try_push_n(const T* items, std::size_t count) {
+        std::size_t n = 0;
+        while (n < count && tryEnqueue(items[n])) {
+            ++n;
+        }
+        if (n > 0) {
+            notEmpty_.notify(static_cast<int>(std::min<std::size_t>(n, INT_MAX)));
+        }
+        return n;
+    }
+
+    std::size_t try_pop_n(T* out, std::size_t maxCount) {
+        std::size_t n = 0;
+        while (n < maxCount && tryDequeue(out[n])) {
+            ++n;
+        }
+        if (n > 0) {
+            notFull_.notify(static_cast<int>(std::min<std::size_t>(n, INT_MAX)));
+        }
+        return n;
+    }
+
+    // Blocks while the queue is full; false if the queue is (or becomes) closed.
+    template <typename U>
+    bool push(U&& value) {
+        for (int round = 0;; ++round) {
+            // Forwarding on every attempt is safe: the value is only moved from once a cell is claimed.
+            if (tryEnqueue(std::forward<U>(value))) {
+                notEmpty_.notify();
+                return true;
+            }
+            if (closed()) {
+                return false;
+            }
+            if (round < kMpmcSpinRounds) {
+                cpuRelax();
+            } else if (round < kMpmcSpinRounds + kMpmcYieldRounds) {
+                std::this_thread::yield();
+            } else {
+                const std::uint32_t ticket = notFull_.prepareWait();
+                if (tryEnqueue(std::forward<U>(value))) {
+                    notFull_.cancelWait();
+                    notEmpty_.notify();
+                    return true;
+                }
+                if (closed()) {
+                    notFull_.cancelWait();
+                    return false;
+                }
+                notFull_.wait(ticket);
+            }
+        }
+    }
+
+    // Blocks while the queue is empty; false once it is closed and drained.
+    bool pop(T& out) {
+        for (int round = 0;; ++round) {
+            if (try_pop(out)) {
+                return true;
+            }
+            if (closed()) {
+                return drainClosed(out); // Items pushed before close() are still delivered
+            }
+            if (round < kMpmcSpinRounds) {
+                cpuRelax();
+            } else if (round < kMpmcSpinRounds + kMpmcYieldRounds) {
+                std::this_thread::yield();
+            } else {
+                const std::uint32_t ticket = notEmpty_.prepareWait();
+                if (tryDequeue(out)) {
+                    notEmpty_.cancelWait();
+                    notFull_.notify();
+                    return true;
+                }
+                if (closed()) {
+                    notEmpty_.cancelWait();
+                    return drainClosed(out);
+                }
+                notEmpty_.wait(ticket);
+            }
+        }
+    }
+
+    // Makes every later push()/try_push() fail; items claimed before it are still delivered by pop().
+    void close() {
+        enqueuePos_.fetch_or(kClosedBit, std::memory_order_seq_cst);
+        notEmpty_.notifyAll();
+        notFull_.notifyAll();
+    }
+
+    bool closed() const { return (enqueuePos_.load(std::memory_order_acquire) & kClosedBit) != 0; }
+    std::size_t capacity() const { return mask_ + 1; }
+
+    // Approximate under concurrent use.
+    std::size_t size() const {
+        const std::size_t head = dequeuePos_.load(std::memory_order_relaxed);
+        const std::size_t tail = enqueuePos_.load(std::memory_order_relaxed) & ~kClosedBit;
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    static constexpr std::size_t kClosedBit = ~(~std::size_t(0) >> 1);
+
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    template <typename U>
+    bool tryEnqueue(U&& value) {
+        std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            if (pos & kClosedBit) {
+                return false; // Closed: a failed CAS below reloads pos, so a racing close() is seen here
+            }
+            cell = &cells_[pos & mask_];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // Full: the cell still holds the item from one lap ago
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed); // Another producer claimed pos
+            }
+        }
+        new (&cell->storage) T(std::forward<U>(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryDequeue(T& out) {
+        std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // Empty
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        T* item = reinterpret_cast<T*>(&cell->storage);
+        out = std::move(*item);
+        item->~T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release); // Free for the next lap
+        return true;
+    }
+
+    // After close() the enqueue counter is final. Claims below it may still be publishing, so wait for
+    // them instead of reporting the queue drained early.
+    bool drainClosed(T& out) {
+        const std::size_t tail = enqueuePos_.load(std::memory_order_acquire) & ~kClosedBit;
+        for (int round = 0;; ++round) {
+            if (try_pop(out)) {
+                return true;
+            }
+            if (dequeuePos_.load(std::memory_order_relaxed) >= tail) {
+                return false;
+            }
+            if (round < kMpmcSpinRounds) {
+                cpuRelax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::unique_ptr<Cell[]> cells_;
+    std::size_t mask_ = 0;
+    alignas(64) std::atomic<std::size_t> enqueuePos_{0}; // Top bit: closed
+    alignas(64) std::atomic<std::size_t> dequeuePos_{0};
+    alignas(64) FutexEvent notEmpty_;
+    FutexEvent notFull_;
+};
+
+//------------------------------------------------------------------------------
+// Section 3: Benchmark - Locked std::queue vs. MpmcQueue
+//------------------------------------------------------------------------------
+
+// The design MpmcQueue replaces: std::queue + mutex + condition variable, notify_one per push.
+template <typename T>
+class LockedQueue {
+public:
+    bool push(T value) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_) {
+                return false;
+            }
+            items_.push(std::move(value));
+        }
+        cv_.notify_one();
+        return true;
+    }
+
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return !items_.empty() || closed_; });
+        if (items_.empty()) {
+            return false;
+        }
+        out = std::move(items_.front());
+        items_.pop();
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        cv_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::queue<T> items_;
+    bool closed_ = false;
+};
+
+/*
+ * Function: queueThroughput()
+ *
+ * Purpose: `producers` threads push `items` integers in total, `consumers` threads pop until the queue
+ *          is closed and drained. Returns millions of items per second (0 if items went missing).
+ */
+template <typename Queue>
+double queueThroughput(Queue& queue, unsigned producers, unsigned consumers, std::size_t items) {
+    std::atomic<std::size_t> received{0};
+    std::atomic<std::uint64_t> checksum{0};
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> consumerThreads;
+    for (unsigned c = 0; c < consumers; ++c) {
+        consumerThreads.emplace_back([&] {
+            std::size_t count = 0;
+            std::uint64_t sum = 0;
+            std::size_t value;
+            while (queue.pop(value)) {
+                ++count;
+                sum += value;
+            }
+            received.fetch_add(count, std::memory_order_relaxed);
+            checksum.fetch_add(sum, std::memory_order_relaxed);
+        });
+    }
+    std::vector<std::thread> producerThreads;
+    for (unsigned p = 0; p < producers; ++p) {
+        producerThreads.emplace_back([&, p] {
+            for (std::size_t i = p; i < items; i += producers) {
+                queue.push(i);
+            }
+        });
+    }
+    for (std::thread& t : producerThreads) t.join();
+    queue.close();
+    for (std::thread& t : consumerThreads) t.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const bool complete = received.load() == items && checksum.load() == std::uint64_t(items) * (items - 1) / 2;
+    return complete ? items / seconds / 1e6 : 0.0;
+}
+
+// The 1-thread point: push and pop each item on the calling thread; the queue's cost without any hand-off.
+template <typename Queue>
+double queueSingleThreadThroughput(Queue& queue, std::size_t items) {
+    std::uint64_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    std::size_t value = 0;
+    for (std::size_t i = 0; i < items; ++i) {
+        queue.push(i);
+        queue.pop(value);
+        checksum += value;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return checksum == std::uint64_t(items) * (items - 1) / 2 ? items / seconds / 1e6 : 0.0;
+}
+
+void benchmarkMpmcQueue(std::size_t items) {
+    std::cout << "Items/s through the queue (half producers, half consumers), " << items << " items:\n";
+    for (unsigned threads = 1; threads <= 64; threads *= 2) {
+        const unsigned producers = threads / 2;
+        const unsigned consumers = threads - producers;
+        LockedQueue<std::size_t> locked;
+        MpmcQueue<std::size_t> lockFree(1024);
+        const bool single = threads == 1;
+        const double lockedRate = single ? queueSingleThreadThroughput(locked, items)
+                                         : queueThroughput(locked, producers, consumers, items);
+        const double lockFreeRate = single ? queueSingleThreadThroughput(lockFree, items)
+                                           : queueThroughput(lockFree, producers, consumers, items);
+        const std::string shape = single ? "1 thread (push + pop in turn)"
+                                         : std::to_string(threads) + " threads (" + std::to_string(producers) + "P/" +
+                                               std::to_string(consumers) + "C)";
+        std::cout << "  " << shape << ": mutex + condvar "
+                  << lockedRate << " M/s, MpmcQueue " << lockFreeRate << " M/s ("
+                  << (lockedRate > 0 ? lockFreeRate / lockedRate : 0.0) << "x)\n";
+    }
+}
+
+//------------------------------------------------------------------------------
+// Section 4: Demonstration
+//------------------------------------------------------------------------------
+
+void runMpmcQueueExamples() {
+    std::cout << "\n--- Bounded Lock-Free MPMC Queue ---\n";
+    MpmcQueue<int> queue(4);
+    for (int i = 0; i < 5; ++i) {
+        std::cout << "try_push(" << i << "): " << (queue.try_push(i) ? "ok" : "full") << "\n";
+    }
+    queue.close();
+    std::cout << "After close(): push " << (queue.push(99) ? "accepted" : "rejected") << ", draining:";
+    int value;
+    while (queue.pop(value)) {
+        std::cout << " " << value;
+    }
+    std::cout << "\n";
+    std::cout << "Park strategy: spin " << kMpmcSpinRounds << ", yield " << kMpmcYieldRounds << ", then "
+              << (MPMCQUEUE_HAS_FUTEX ? "futex" : "sleep polling") << "\n";
+    benchmarkMpmcQueue(1 << 20);
+}
+
+#endif // MPMCQUEUE_H
@@ -4,40 +4,46 @@
 #include <iostream>
 #include <thread>
 #include <mutex>
-#include <condition_variable>
-#include <queue>
+#include <functional>
+#include "BatchChannel.h"
 
-std::mutex mtx;
-std::condition_variable cv;
-std::queue<int> dataQueue;
+std::mutex mtx;  // Serializes console output only; the channel needs no lock
 
-void producer(int id) {
-    for (int i = 0; i < 5; ++i) {
-        std::unique_lock<std::mutex> lock(mtx);
-        std::cout << "Producer " << id << " adding data " << i << "\n";
-        dataQueue.push(i);
-        lock.unlock();
-        cv.notify_one();  // Notify one waiting thread
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+void producer(int id, BatchChannel<int>& dataQueue) {
+    int batch[4];
+    for (int b = 0; b < 3; ++b) {
+        for (int i = 0; i < 4; ++i) {
+            batch[i] = b * 4 + i;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            std::cout << "Producer " << id << " adding data " << batch[0] << ".." << batch[3] << "\n";
+        }
+        dataQueue.push_batch(batch, 4);  // One consumer wakeup per batch; waits at the high-water mark
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
+    dataQueue.close();  // No more data: the consumer drains what is left, then stops
 }
 
-void consumer(int id) {
-    while (true) {
-        std::unique_lock<std::mutex> lock(mtx);
-        cv.wait(lock, []{ return !dataQueue.empty(); });  // Wait until the queue is not empty
-        int data = dataQueue.front();
-        dataQueue.pop();
-        std::cout << "Consumer " << id << " got data " << data << "\n";
-        if (dataQueue.empty() && data == 4) break;  // Exit condition for simplicity
+void consumer(int id, BatchChannel<int>& dataQueue) {
+    int data[8];
+    while (std::size_t n = dataQueue.pop_batch(data, 8)) {  // Up to 8 items per wakeup; 0 once closed and empty
+        std::lock_guard<std::mutex> lock(mtx);
+        std::cout << "Consumer " << id << " got " << n << " items:";
+        for (std::size_t i = 0; i < n; ++i) {
+            std::cout << " " << data[i];
+        }
+        std::cout << "\n";
     }
 }
 
 void runMultithreadingAndConcurrency() {
-    std::thread t1(producer, 1);
-    std::thread t2(consumer, 1);
+    BatchChannel<int> dataQueue(8);  // Bounded: producers wait once 8 items are buffered
+    std::thread t1(producer, 1, std::ref(dataQueue));
+    std::thread t2(consumer, 1, std::ref(dataQueue));
     t1.join();
     t2.join();
+    printBatchChannelStats(dataQueue.stats());
 }
 
 #endif
@@ -0,0 +1,433 @@
+#ifndef RECORDINDEX_H
+#define RECORDINDEX_H
+
+#include <iostream>       // For standard input/output operations (cout, cerr)
+#include <fstream>        // For reading and writing indexed record files
+#include <vector>         // For the in-memory sparse index and page buffers
+#include <cstdint>        // For fixed-width integer types
+#include <cstring>        // For memcpy/memcmp
+#include <cstdio>         // For std::remove (cleanup of demo files)
+#include <chrono>         // For timing lookups
+#include <random>         // For shuffling and picking lookup keys
+#include <algorithm>      // For std::shuffle, std::lower_bound
+
+#include "ByteStreaming.h"       // For MyData
+#include "BinarySerialization.h" // For the record stream format
+
+//------------------------------------------------------------------------------
+// Section 1: Point Lookups Without Full Scans
+//------------------------------------------------------------------------------
+
+/*
+ * The Problem:
+ * - To find the MyData with a given id in data.bin, the only option is to read every record.
+ *
+ * Index Footer:
+ * - The writer uses the paged record layout of BinarySerialization.h (kRecordFlagPagedRecords): the
+ *   records start at offset 4096 and every page of kIndexPageRecords records (341 * 12 bytes) is padded
+ *   to 4096 bytes, so each data page is exactly one aligned 4 KiB block. After the last page it appends
+ *   an index describing those pages, each part starting on a 4 KiB boundary:
+ *
+ *   Sparse index: one entry per data page: int32 min id, int32 max id (8 bytes per ~4 KiB of data).
+ *     If the records were written in id order (flag kIndexSorted), the entries are sorted too, and a
+ *     binary search over them identifies the single data page that can contain an id.
+ *
+ *   Hash directory (optional): an open-addressing table of 8-byte slots { int32 id, uint32 page },
+ *     sized to a power of two at most 50% full. A lookup hashes the id, reads the one 4 KiB directory
+ *     page holding that slot (linear probing rarely leaves it) and then reads one data page.
+ *     This works for records in any order, at a cost of ~16 bytes of directory per record.
+ *
+ *   Trailer (40 bytes, at the very end of the file):
+ *     char[4] "CCIX", uint32 flags, uint32 records per page, uint32 page bytes,
+ *     uint64 sparse index offset, uint64 hash directory offset, uint64 hash slot count (0 = none)
+ *
+ * - The record stream header carries kRecordFlagIndexFooter | kRecordFlagPagedRecords. deserialize()
+ *   skips the page padding and ignores everything after the last page, so indexed files remain readable
+ *   by the plain reader.
+ * - The reader keeps the sparse index in memory (it is ~0.2% of the data) and reads the file only in
+ *   aligned 4 KiB blocks, so a sorted lookup reads one block and a hash lookup one directory block
+ *   (linear probing rarely needs a second) and one data block.
+ */
+
+const char kIndexMagic[4] = {'C', 'C', 'I', 'X'};
+const std::size_t kIndexTrailerSize = 40;
+const std::size_t kIndexPageRecords = kRecordsPerPage; // 341 records per data page
+const std::size_t kIndexPageBytes = kRecordPageBytes;
+const std::size_t kHashSlotSize = 8;
+const std::uint32_t kEmptyHashSlot = 0xFFFFFFFFu;
+const std::uint32_t kIndexSorted = 0x1;
+const std::uint32_t kIndexHasHashDirectory = 0x2;
+
+struct RecordIndexOptions {
+    bool hashDirectory = false; // Emit a hash directory (needed for fast lookups in unsorted files)
+};
+
+// Finalizer from MurmurHash3: spreads consecutive ids over the whole table.
+std::uint32_t hashRecordId(std::int32_t id) {
+    std::uint32_t h = static_cast<std::uint32_t>(id);
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+//------------------------------------------------------------------------------
+// Section 2: Writing an Indexed Record File
+//------------------------------------------------------------------------------
+
+/*
+ * Function: serializeWithIndex()
+ *
+ * Purpose: Write `count` records in the fixed record layout followed by an index footer.
+ *          Duplicate ids are allowed; the hash directory then points at the first page containing the id.
+ */
+bool serializeWithIndex(std::ostream& out, const MyData* records, std::size_t count,
+                        RecordIndexOptions options = RecordIndexOptions()) {
+    RecordStreamHeader header;
+    header.flags = kRecordFlagIndexFooter | kRecordFlagPagedRecords;
+    header.recordCount = count;
+    if (!writeRecordStreamHeader(out, header)) {
+        return false;
+    }
+    const std::size_t pages = (count + kIndexPageRecords - 1) / kIndexPageRecords;
+
+    // Data pages: zero padding up to the first 4 KiB boundary, then one padded 4 KiB block per page.
+    std::vector<unsigned char> batch(kIndexPageBytes, 0);
+    if (pages > 0) {
+        out.write(reinterpret_cast<const char*>(batch.data()), static_cast<std::streamsize>(kIndexPageBytes - kRecordStreamHeaderSize));
+    }
+    const std::size_t pagesPerWrite = kSerializationBatchRecords / kIndexPageRecords;
+    for (std::size_t p = 0; p < pages; p += pagesPerWrite) {
+        const std::size_t n = std::min(pages - p, pagesPerWrite);
+        batch.assign(n * kIndexPageBytes, 0);
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::size_t first = (p + i) * kIndexPageRecords;
+            const std::size_t end = std::min(count, first + kIndexPageRecords);
+            for (std::size_t r = first; r < end; ++r) {
+                encodeRecord(records[r], batch.data() + i * kIndexPageBytes + (r - first) * kWireRecordSize);
+            }
+        }
+        out.write(reinterpret_cast<const char*>(batch.data()), static_cast<std::streamsize>(batch.size()));
+    }
+
+    // Sparse index, padded to the next 4 KiB boundary
+    std::uint32_t flags = kIndexSorted;
+    std::vector<unsigned char> sparse(pages * 8);
+    for (std::size_t p = 0; p < pages; ++p) {
+        std::int32_t lo = records[p * kIndexPageRecords].id;
+        std::int32_t hi = lo;
+        const std::size_t end = std::min(count, (p + 1) * kIndexPageRecords);
+        for (std::size_t i = p * kIndexPageRecords; i < end; ++i) {
+            lo = std::min(lo, records[i].id);
+            hi = std::max(hi, records[i].id);
+            if (i > 0 && records[i].id < records[i - 1].id) {
+                flags &= ~kIndexSorted;
+            }
+        }
+        storeLittleEndian<std::uint32_t>(sparse.data() + p * 8, static_cast<std::uint32_t>(lo));
+        storeLittleEndian<std::uint32_t>(sparse.data() + p * 8 + 4, static_cast<std::uint32_t>(hi));
+    }
+    const std::uint64_t sparseOffset = pages > 0 ? kIndexPageBytes * (1 + pages) : kRecordStreamHeaderSize;
+    sparse.resize((sparse.size() + kIndexPageBytes - 1) / kIndexPageBytes * kIndexPageBytes, 0);
+    if (pages == 0) {
+        sparse.resize(kIndexPageBytes - kRecordStreamHeaderSize, 0);
+    }
+    out.write(reinterpret_cast<const char*>(sparse.data()), static_cast<std::streamsize>(sparse.size()));
+
+    // Optional hash directory (a whole number of 4 KiB blocks)
+    std::uint64_t slots = 0;
+    const std::uint64_t hashOffset = sparseOffset + sparse.size();
+    if (options.hashDirectory && count > 0) {
+        flags |= kIndexHasHashDirectory;
+        slots = kIndexPageBytes / kHashSlotSize;
+        while (slots < 2 * static_cast<std::uint64_t>(count)) slots *= 2;
+        std::vector<unsigned char> table(static_cast<std::size_t>(slots) * kHashSlotSize, 0xFF);
+        const std::uint64_t mask = slots - 1;
+        for (std::size_t i = 0; i < count; ++i) {
+            std::uint64_t slot = hashRecordId(records[i].id) & mask;
+            while (true) {
+                unsigned char* s = table.data() + slot * kHashSlotSize;
+                if (loadLittleEndian<std::uint32_t>(s + 4) == kEmptyHashSlot) {
+                    storeLittleEndian<std::uint32_t>(s, static_cast<std::uint32_t>(records[i].id));
+                    storeLittleEndian<std::uint32_t>(s + 4, static_cast<std::uint32_t>(i / kIndexPageRecords));
+                    break;
+                }
+                if (static_cast<std::int32_t>(loadLittleEndian<std::uint32_t>(s)) == records[i].id) {
+                    break; // Keep the first page for duplicate ids
+                }
+                slot = (slot + 1) & mask;
+            }
+        }
+        out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size()));
+    }
+
+    unsigned char trailer[kIndexTrailerSize] = {};
+    std::memcpy(trailer, kIndexMagic, sizeof(kIndexMagic));
+    storeLittleEndian<std::uint32_t>(trailer + 4, flags);
+    storeLittleEndian<std::uint32_t>(trailer + 8, static_cast<std::uint32_t>(kIndexPageRecords));
+    storeLittleEndian<std::uint32_t>(trailer + 12, static_cast<std::uint32_t>(kIndexPageBytes));
+    storeLittleEndian<std::uint64_t>(trailer + 16, sparseOffset);
+    storeLittleEndian<std::uint64_t>(trailer + 24, hashOffset);
+    storeLittleEndian<std::uint64_t>(trailer + 32, slots);
+    out.write(reinterpret_cast<const char*>(trailer), sizeof(trailer));
+    return static_cast<bool>(out);
+}
+
+//------------------------------------------------------------------------------
+// Section 3: Point Lookups - IndexedRecordReader::find()
+//------------------------------------------------------------------------------
+
+class IndexedRecordReader {
+public:
+    explicit IndexedRecordReader(const char* path) : in_(path, std::ios::binary) {
+        if (!in_ || !readFooter()) {
+            in_.close();
+        }
+    }
+
+    bool isOpen() const { return in_.is_open(); }
+    explicit operator bool() const { return in_.is_open(); }
+    bool isSorted() const { return (flags_ & kIndexSorted) != 0; }
+    bool hasHashDirectory() const { return slots_ != 0; }
+    std::uint64_t recordCount() const { return recordCount_; }
+    std::uint64_t indexPagesRead() const { return indexPagesRead_; }
+    std::uint64_t dataPagesRead() const { return dataPagesRead_; }
+    std::uint64_t bytesRead() const { return bytesRead_; }           // Sparse index load excluded
+    std::uint64_t unalignedReads() const { return unalignedReads_; } // Always 0 for a well-formed file
+
+    /*
+     * Function: find()
+     *
+     * Purpose: Look up the record with `id`.
+     *          - Hash directory present: one directory page + one data page.
+     *          - Sorted file: binary search of the in-memory sparse index + one data page.
+     *          - Otherwise: only the data pages whose [min, max] id range contains `id` are read.
+     * Returns: true and fills `result` if a record with `id` exists.
+     */
+    bool find(std::int32_t id, MyData& result) {
+        if (!in_.is_open()) {
+            return false;
+        }
+        if (slots_ != 0) {
+            std::uint32_t page;
+            return lookupHash(id, page) && searchPage(page, id, result);
+        }
+        if (isSorted()) {
+            // First page whose max id is >= id
+            std::size_t lo = 0, hi = pageRanges_.size();
+            while (lo < hi) {
+                const std::size_t mid = (lo + hi) / 2;
+                if (pageRanges_[mid].second < id) lo = mid + 1; else hi = mid;
+            }
+            return lo < pageRanges_.size() && pageRanges_[lo].first <= id && searchPage(lo, id, result);
+        }
+        for (std::size_t p = 0; p < pageRanges_.size(); ++p) {
+            if (pageRanges_[p].first <= id && id <= pageRanges_[p].second && searchPage(p, id, result)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    bool readFooter() {
+        RecordStreamHeader header;
+        const std::uint16_t required = kRecordFlagIndexFooter | kRecordFlagPagedRecords;
+        if (!readRecordStreamHeader(in_, header) || (header.flags & required) != required) {
+            return false;
+        }
+        recordCount_ = header.recordCount;
+
+        unsigned char trailer[kIndexTrailerSize];
+        in_.seekg(-static_cast<std::streamoff>(kIndexTrailerSize), std::ios::end);
+        if (!in_.read(reinterpret_cast<char*>(trailer), sizeof(trailer)) ||
+            std::memcmp(trailer, kIndexMagic, sizeof(kIndexMagic)) != 0 ||
+            loadLittleEndian<std::uint32_t>(trailer + 8) != kIndexPageRecords ||
+            loadLittleEndian<std::uint32_t>(trailer + 12) != kIndexPageBytes) {
+            return false;
+        }
+        flags_ = loadLittleEndian<std::uint32_t>(trailer + 4);
+        const std::uint64_t sparseOffset = loadLittleEndian<std::uint64_t>(trailer + 16);
+        hashOffset_ = loadLittleEndian<std::uint64_t>(trailer + 24);
+        slots_ = (flags_ & kIndexHasHashDirectory) ? loadLittleEndian<std::uint64_t>(trailer + 32) : 0;
+        if (slots_ != 0 && ((slots_ & (slots_ - 1)) != 0 || hashOffset_ % kIndexPageBytes != 0)) {
+            return false; // Slot count must be a power of two, the directory 4 KiB-aligned
+        }
+        if (recordCount_ != 0 && sparseOffset % kIndexPageBytes != 0) {
+            return false;
+        }
+
+        const std::size_t pages = static_cast<std::size_t>((recordCount_ + kIndexPageRecords - 1) / kIndexPageRecords);
+        std::vector<unsigned char> sparse(pages * 8);
+        in_.seekg(static_cast<std::streamoff>(sparseOffset));
+        if (!in_.read(reinterpret_cast<char*>(sparse.data()), static_cast<std::streamsize>(sparse.size()))) {
+            return false;
+        }
+        pageRanges_.resize(pages);
+        for (std::size_t p = 0; p < pages; ++p) {
+            pageRanges_[p].first = static_cast<std::int32_t>(loadLittleEndian<std::uint32_t>(sparse.data() + p * 8));
+            pageRanges_[p].second = static_cast<std::int32_t>(loadLittleEndian<std::uint32_t>(sparse.data() + p * 8 + 4));
+        }
+        return true;
+    }
+
+    // Probe the hash directory, reading one directory page at a time.
+    bool lookupHash(std::int32_t id, std::uint32_t& page) {
+        const std::uint64_t mask = slots_ - 1;
+        const std::uint64_t slotsPerPage = kIndexPageBytes / kHashSlotSize;
+        std::uint64_t slot = hashRecordId(id) & mask;
+        std::uint64_t loadedPage = ~std::uint64_t(0);
+        for (std::uint64_t probes = 0; probes < slots_; ++probes, slot = (slot + 1) & mask) {
+            if (slot / slotsPerPage != loadedPage) {
+                loadedPage = slot / slotsPerPage;
+                if (!readBlock(hashOffset_ + loadedPage * kIndexPageBytes)) {
+                    return false;
+                }
+                ++indexPagesRead_;
+            }
+            const unsigned char* s = page_.data() + (slot % slotsPerPage) * kHashSlotSize;
+            const std::uint32_t slotPage = loadLittleEndian<std::uint32_t>(s + 4);
+            if (slotPage == kEmptyHashSlot) {
+                return false;
+            }
+            if (static_cast<std::int32_t>(loadLittleEndian<std::uint32_t>(s)) == id) {
+                page = slotPage;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Read data page `p` and scan it for `id`.
+    bool searchPage(std::size_t p, std::int32_t id, MyData& result) {
+        const std::uint64_t first = static_cast<std::uint64_t>(p) * kIndexPageRecords;
+        if (first >= recordCount_) {
+            return false;
+        }
+        const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(kIndexPageRecords, recordCount_ - first));
+        if (!readBlock(kIndexPageBytes * (1 + p))) {
+            return false;
+        }
+        ++dataPagesRead_;
+        for (std::size_t i = 0; i < n; ++i) {
+            const unsigned char* r = page_.data() + i * kWireRecordSize;
+            if (static_cast<std::int32_t>(loadLittleEndian<std::uint32_t>(r)) == id) {
+                result = decodeRecord(r);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Every lookup read is one whole, aligned 4 KiB block; anything else is counted and refused.
+    bool readBlock(std::uint64_t offset) {
+        if (offset % kIndexPageBytes != 0) {
+            ++unalignedReads_;
+            return false;
+        }
+        page_.resize(kIndexPageBytes);
+        in_.clear();
+        in_.seekg(static_cast<std::streamoff>(offset));
+        if (!in_.read(reinterpret_cast<char*>(page_.data()), static_cast<std::streamsize>(kIndexPageBytes))) {
+            return false;
+        }
+        bytesRead_ += kIndexPageBytes;
+        return true;
+    }
+
+    std::ifstream in_;
+    std::uint64_t recordCount_ = 0;
+    std::uint32_t flags_ = 0;
+    std::uint64_t hashOffset_ = 0;
+    std::uint64_t slots_ = 0;
+    std::vector<std::pair<std::int32_t, std::int32_t>> pageRanges_;
+    std::vector<unsigned char> page_;
+    std::uint64_t indexPagesRead_ = 0;
+    std::uint64_t dataPagesRead_ = 0;
+    std::uint64_t bytesRead_ = 0;
+    std::uint64_t unalignedReads_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// Section 4: Demonstration
+//------------------------------------------------------------------------------
+
+/*
+ * Function: runRecordIndexExamples()
+ *
+ * Purpose: Builds a sorted file (sparse index only) and a shuffled file (with hash directory), performs
+ *          random point lookups on each and reports pages touched per lookup, compared with a full
+ *          deserialize() scan.
+ */
+void runRecordIndexExamples() {
+    using Clock = std::chrono::steady_clock;
+    std::cout << "\n--- Indexed Record Lookups ---\n";
+
+    const std::size_t recordCount = 2000000;
+    std::vector<MyData> records;
+    records.reserve(recordCount);
+    for (std::size_t i = 0; i < recordCount; ++i) {
+        records.emplace_back(static_cast<int>(i * 5), i * 0.25); // Sorted ids with gaps
+    }
+    std::mt19937 gen(11);
+    std::vector<MyData> shuffled = records;
+    std::shuffle(shuffled.begin(), shuffled.end(), gen);
+
+    const char* sortedFile = "records_indexed_sorted.bin";
+    const char* hashedFile = "records_indexed_hashed.bin";
+    {
+        std::ofstream ofs(sortedFile, std::ios::binary);
+        serializeWithIndex(ofs, records.data(), records.size());
+    }
+    {
+        RecordIndexOptions options;
+        options.hashDirectory = true;
+        std::ofstream ofs(hashedFile, std::ios::binary);
+        serializeWithIndex(ofs, shuffled.data(), shuffled.size(), options);
+    }
+
+    const std::size_t lookups = 10000;
+    for (const char* filename : {sortedFile, hashedFile}) {
+        IndexedRecordReader reader(filename);
+        if (!reader) {
+            std::cerr << "Error: Cannot open indexed file '" << filename << "'.\n";
+            continue;
+        }
+        std::size_t found = 0;
+        std::size_t singleDataBlock = 0; // Lookups that read exactly one aligned 4 KiB data block
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < lookups; ++i) {
+            const std::int32_t id = static_cast<std::int32_t>((gen() % recordCount) * 5);
+            const std::uint64_t dataBefore = reader.dataPagesRead();
+            MyData r(0, 0.0);
+            if (reader.find(id, r) && r.value == (id / 5) * 0.25) ++found;
+            if (reader.dataPagesRead() - dataBefore == 1) ++singleDataBlock;
+        }
+        const double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / lookups;
+        std::cout << (reader.hasHashDirectory() ? "Hash directory (shuffled): " : "Sparse index (sorted):     ")
+                  << us << " us/lookup, " << found << "/" << lookups << " found, "
+                  << static_cast<double>(reader.indexPagesRead()) / lookups << " index + "
+                  << static_cast<double>(reader.dataPagesRead()) / lookups << " data pages per lookup\n";
+        const bool aligned = reader.unalignedReads() == 0 &&
+                             reader.bytesRead() == (reader.indexPagesRead() + reader.dataPagesRead()) * kIndexPageBytes;
+        std::cout << "  " << singleDataBlock << "/" << lookups << " lookups read exactly one 4 KiB data block; "
+                  << "all reads aligned 4 KiB blocks: " << (aligned ? "yes" : "NO") << "\n";
+    }
+
+    // Baseline: a full scan for a single id
+    const auto start = Clock::now();
+    std::vector<MyData> all;
+    std::ifstream ifs(sortedFile, std::ios::binary);
+    deserialize(ifs, all);
+    const auto hit = std::find_if(all.begin(), all.end(), [](const MyData& r) { return r.id == 4999995; });
+    std::cout << "Full scan for one id: " << std::chrono::duration<double, std::micro>(Clock::now() - start).count()
+              << " us (" << (hit != all.end() ? "found" : "not found") << ")\n";
+    ifs.close();
+
+    std::remove(sortedFile);
+    std::remove(hashedFile);
+}
+
+#endif // RECORDINDEX_H
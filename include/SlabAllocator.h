@@ -0,0 +1,753 @@
+#ifndef SLABALLOCATOR_H
+#define SLABALLOCATOR_H
+
+#include <iostream>        // For standard input/output operations (cout)
+#include <memory_resource> // For std::pmr::memory_resource
+#include <new>             // For std::bad_alloc, std::nothrow_t, std::align_val_t
+#include <atomic>          // For owner pointers, remote-free stacks and statistics
+#include <mutex>           // For the global slab cache and orphan lists
+#include <thread>          // For the multithreaded benchmark
+#include <vector>          // For benchmark bookkeeping
+#include <cstdint>         // For std::uintptr_t
+#include <cstddef>         // For std::size_t
+#include <chrono>          // For timing the benchmark
+#include <random>          // For random allocation sizes
+#include <cstdlib>         // For std::malloc/std::free in the comparison
+#include <type_traits>     // For std::true_type
+
+#include <sys/mman.h>      // For mmap(), munmap() and madvise()
+
+//------------------------------------------------------------------------------
+// Section 1: Size-Class Slabs, Magazines and Remote Frees
+//------------------------------------------------------------------------------
+
+/*
+ * Why another allocator?
+ * - The threads started by runConcurrentProgramming() all allocate from the global heap. A general-purpose
+ *   heap has to synchronize somewhere, and under contention that shared state stops scaling.
+ * - This allocator gives every thread its own heap, so the common case touches no shared data at all.
+ *
+ * Design:
+ * - Size classes: 16..128 bytes in steps of 16, then four classes per power of two up to 8 KiB
+ *   (160, 192, 224, 256, 320, ...): at most 25% internal waste. Larger requests get their own mapping.
+ *   Objects start kSlabHeaderBytes into the slab, so a class whose size is a multiple of 32 or 64 hands
+ *   out 32- or 64-byte aligned objects; requests aligned up to kSlabMaxClassAlignment use such a class.
+ * - Slabs: 64 KiB blocks aligned to 64 KiB, each holding objects of one size class and owned by one
+ *   thread. The header sits at the start of the slab, so `ptr & ~(64 KiB - 1)` finds the metadata of
+ *   any object in O(1) without a lookup table.
+ * - Magazines: each thread keeps a small stack of free objects per class. allocate() pops from it and
+ *   deallocate() pushes to it; only when a magazine runs empty or full does the thread touch its slabs,
+ *   moving half a magazine at a time.
+ * - Remote frees: an object freed by a thread that does not own its slab is pushed onto the slab's
+ *   lock-free remote stack (one CAS) and counted. The owner takes the whole stack with a single exchange
+ *   when it next needs memory from that slab. Every kSlabRemoteSweepInterval trips into its slow path
+ *   (refill or flush) for a class, the owner also drains every slab of that class with at least
+ *   kSlabRemoteDrainThreshold remote frees pending, or with enough to empty it, and releases the slabs
+ *   that become empty. A producer/consumer pair therefore gives pages back while the producer keeps
+ *   allocating.
+ * - Page-level return: a slab whose objects have all come back is given up by its owner. Up to
+ *   kSlabCacheLimit such slabs are cached with their pages released via madvise(MADV_DONTNEED); beyond
+ *   that they are unmapped.
+ * - Thread exit: the thread's magazines are flushed, empty slabs are released and slabs that still hold
+ *   live objects become orphans, adopted by the next thread that needs a slab of that class.
+ *
+ * Limits:
+ * - Only the owner touches a slab's free lists and counts, and a remote freer never dereferences the
+ *   owner (it may have exited). So a slab emptied by remote frees while its owner allocates and frees
+ *   nothing of that class is not released until the owner's next slow path for the class, or until
+ *   the owner exits.
+ * - This is a standalone allocator, not built on CustomMemoryAllocators.h. SimpleAllocator<T> there
+ *   derives from std::allocator<T> and so gets its memory from operator new, which this allocator
+ *   replaces under SLABALLOCATOR_GLOBAL_NEW; it also records telemetry on every call. SlabAllocator<T>
+ *   (Section 4) keeps SimpleAllocator's container-facing shape on top of slabAllocate() instead.
+ *
+ * The allocator never calls operator new itself (only mmap), so it can back the global operator new:
+ * define SLABALLOCATOR_GLOBAL_NEW (CMake option SLABALLOCATOR_GLOBAL_NEW) to route every new/delete
+ * in the program through it.
+ */
+
+const std::size_t kSlabBytes = 64 * 1024;
+const std::size_t kSlabHeaderBytes = 128;
+const std::size_t kSlabMinAlignment = 16;
+const std::size_t kSlabMaxClassAlignment = 64; // Largest alignment served from size classes
+const std::size_t kSlabMaxSmallSize = 8192;
+const std::size_t kSlabSizeClassCount = 32;
+const std::size_t kSlabMagazineCapacity = 64;
+const std::size_t kSlabCacheLimit = 32;
+const std::int32_t kSlabRemoteDrainThreshold = 64; // Pending remote frees that make a slab worth draining
+const std::uint32_t kSlabRemoteSweepInterval = 16; // Slow-path trips per class between sweeps
+const std::size_t kSlabPageBytes = 4096;
+const std::uint32_t kSlabLargeClass = 0xFFFFFFFFu;
+
+// Object size of size class `c`.
+constexpr std::size_t slabClassSize(std::size_t c) {
+    return c < 8 ? (c + 1) * 16
+                 : (std::size_t(128) << ((c - 8) / 4)) + ((c - 8) % 4 + 1) * (std::size_t(128) << ((c - 8) / 4)) / 4;
+}
+
+// Size class per 16-byte step: a table lookup has no data-dependent branch to mispredict on mixed sizes.
+struct SlabClassTable {
+    unsigned char classOf[kSlabMaxSmallSize / 16 + 1];
+};
+
+constexpr SlabClassTable makeSlabClassTable() {
+    SlabClassTable table{};
+    std::size_t c = 0;
+    for (std::size_t step = 0; step <= kSlabMaxSmallSize / 16; ++step) {
+        while (slabClassSize(c) < step * 16) {
+            ++c;
+        }
+        table.classOf[step] = static_cast<unsigned char>(c);
+    }
+    return table;
+}
+
+constexpr SlabClassTable kSlabClassTable = makeSlabClassTable();
+
+// Smallest size class holding `bytes` (bytes <= kSlabMaxSmallSize).
+std::size_t slabSizeClass(std::size_t bytes) {
+    return kSlabClassTable.classOf[(bytes + 15) / 16];
+}
+
+// Smallest size class holding `bytes` whose objects are all `alignment`-aligned (a power of two up to
+// kSlabMaxClassAlignment). Every class from 192 bytes up is a multiple of 64, so the search is short.
+std::size_t slabAlignedSizeClass(std::size_t bytes, std::size_t alignment) {
+    std::size_t c = slabSizeClass((bytes + alignment - 1) & ~(alignment - 1));
+    while (slabClassSize(c) % alignment != 0) {
+        ++c;
+    }
+    return c;
+}
+
+// Objects kept per magazine: fewer for large classes so a thread does not hoard memory.
+std::size_t slabMagazineCapacity(std::size_t c) {
+    const std::size_t byBytes = 32 * 1024 / slabClassSize(c);
+    return byBytes < 8 ? 8 : (byBytes > kSlabMagazineCapacity ? kSlabMagazineCapacity : byBytes);
+}
+
+struct SlabFreeObject {
+    SlabFreeObject* next;
+};
+
+class SlabThreadHeap;
+
+struct SlabHeader {
+    std::atomic<SlabThreadHeap*> owner;     // nullptr while orphaned
+    std::uint32_t sizeClass;                // kSlabLargeClass for a dedicated large mapping
+    std::uint32_t capacity;                 // Objects that fit in the slab
+    std::uint32_t carved;                   // Objects handed out from the never-used tail so far
+    std::uint32_t used;                     // Objects not on localFree (live, in a magazine or remote-freed)
+    SlabFreeObject* localFree;              // Owner-only free list
+    SlabHeader* next;                       // Owner's per-class slab list, or the global cache/orphan list
+    SlabHeader* prev;
+    std::size_t mappingBytes;               // Large mappings only
+    alignas(64) std::atomic<SlabFreeObject*> remoteFree; // Pushed by other threads, drained by the owner
+    std::atomic<std::int32_t> remotePending;              // Counted before the push, minus collected: a hint
+};
+
+static_assert(sizeof(SlabHeader) <= kSlabHeaderBytes, "slab header must fit in kSlabHeaderBytes");
+
+SlabHeader* slabOf(const void* p) {
+    return reinterpret_cast<SlabHeader*>(reinterpret_cast<std::uintptr_t>(p) & ~(kSlabBytes - 1));
+}
+
+struct SlabStats {
+    std::atomic<std::size_t> slabsMapped{0};
+    std::atomic<std::size_t> slabsUnmapped{0};
+    std::atomic<std::size_t> slabsCachedEmpty{0}; // Pages returned with MADV_DONTNEED, mapping kept
+    std::atomic<std::size_t> largeMappings{0};
+    std::atomic<std::size_t> remoteFrees{0};
+};
+
+struct SlabGlobalState {
+    std::mutex mutex;
+    SlabHeader* emptyCache = nullptr;
+    std::size_t emptyCount = 0;
+    SlabHeader* orphans[kSlabSizeClassCount] = {};
+    SlabStats stats;
+};
+
+// Constant-initialized and trivially destructible: usable before main() and after static destruction.
+SlabGlobalState slabGlobalState;
+
+//------------------------------------------------------------------------------
+// Section 2: Mapping Memory
+//------------------------------------------------------------------------------
+
+/*
+ * Function: slabMapAligned()
+ *
+ * Purpose: Map `bytes` (a multiple of the page size) at a kSlabBytes-aligned address by over-mapping
+ *          and trimming the unaligned head and tail.
+ */
+void* slabMapAligned(std::size_t bytes) {
+    void* raw = mmap(nullptr, bytes + kSlabBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw);
+    const std::uintptr_t aligned = (start + kSlabBytes - 1) & ~(kSlabBytes - 1);
+    if (aligned > start) {
+        munmap(raw, aligned - start);
+    }
+    const std::uintptr_t end = start + bytes + kSlabBytes;
+    if (end > aligned + bytes) {
+        munmap(reinterpret_cast<void*>(aligned + bytes), end - (aligned + bytes));
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+/*
+ * Function: slabAllocateLarge()
+ *
+ * Purpose: Requests above kSlabMaxSmallSize (or with alignment above kSlabMaxClassAlignment) get a
+ *          dedicated mapping with a slab header in front, so deallocation can recognize them. Alignments above kSlabBytes / 2
+ *          are not supported (nullptr).
+ */
+void* slabAllocateLarge(std::size_t bytes, std::size_t alignment) {
+    const std::size_t offset = alignment > kSlabHeaderBytes ? alignment : kSlabHeaderBytes;
+    if (offset > kSlabBytes / 2 || bytes > (std::size_t(1) << 46)) {
+        return nullptr;
+    }
+    const std::size_t mapping = (offset + bytes + kSlabPageBytes - 1) & ~(kSlabPageBytes - 1);
+    void* base = slabMapAligned(mapping);
+    if (base == nullptr) {
+        return nullptr;
+    }
+    SlabHeader* header = static_cast<SlabHeader*>(base);
+    header->owner.store(nullptr, std::memory_order_relaxed);
+    header->sizeClass = kSlabLargeClass;
+    header->mappingBytes = mapping;
+    slabGlobalState.stats.largeMappings.fetch_add(1, std::memory_order_relaxed);
+    return static_cast<char*>(base) + offset;
+}
+
+//------------------------------------------------------------------------------
+// Section 3: Per-Thread Heaps
+//------------------------------------------------------------------------------
+
+class SlabThreadHeap {
+public:
+    void* allocate(std::size_t c) {
+        Magazine& m = magazines_[c];
+        if (m.count == 0 && !refill(c)) {
+            return nullptr;
+        }
+        return m.items[--m.count];
+    }
+
+    // Free an object of a slab owned by this heap.
+    void deallocateLocal(SlabHeader* slab, void* p) {
+        const std::size_t c = slab->sizeClass;
+        Magazine& m = magazines_[c];
+        if (m.count == m.limit) {
+            flush(c, m.count / 2);
+        }
+        m.items[m.count++] = p;
+    }
+
+    // Called once when the owning thread exits.
+    void teardown() {
+        for (std::size_t c = 0; c < kSlabSizeClassCount; ++c) {
+            flush(c, magazines_[c].count);
+            SlabHeader* slab = slabs_[c];
+            slabs_[c] = nullptr;
+            while (slab != nullptr) {
+                SlabHeader* next = slab->next;
+                collectRemote(slab);
+                if (slab->used == 0) {
+                    releaseSlab(slab);
+                } else {
+                    orphan(slab);
+                }
+                slab = next;
+            }
+        }
+    }
+
+private:
+    struct Magazine {
+        void* items[kSlabMagazineCapacity];
+        std::size_t count;
+        std::size_t limit; // slabMagazineCapacity(c), set by the first refill
+    };
+
+    char* objectAt(SlabHeader* slab, std::size_t index) const {
+        return reinterpret_cast<char*>(slab) + kSlabHeaderBytes + index * slabClassSize(slab->sizeClass);
+    }
+
+    // Move the remote-free stack onto the local free list.
+    static void collectRemote(SlabHeader* slab) {
+        SlabFreeObject* list = slab->remoteFree.exchange(nullptr, std::memory_order_acquire);
+        std::int32_t collected = 0;
+        while (list != nullptr) {
+            SlabFreeObject* next = list->next;
+            list->next = slab->localFree;
+            slab->localFree = list;
+            --slab->used;
+            ++collected;
+            list = next;
+        }
+        if (collected != 0) {
+            slab->remotePending.fetch_sub(collected, std::memory_order_relaxed);
+        }
+    }
+
+    // Every kSlabRemoteSweepInterval-th slow path of class `c`: drain slabs with many remote frees
+    // pending (or enough to empty them) and release the ones that become empty.
+    void sweepRemote(std::size_t c) {
+        if (++sweepTicks_[c] < kSlabRemoteSweepInterval) {
+            return;
+        }
+        sweepTicks_[c] = 0;
+        SlabHeader* slab = slabs_[c] != nullptr ? slabs_[c]->next : nullptr; // The current slab stays
+        while (slab != nullptr) {
+            SlabHeader* next = slab->next;
+            const std::int32_t pending = slab->remotePending.load(std::memory_order_relaxed);
+            if (pending >= kSlabRemoteDrainThreshold || (pending > 0 && static_cast<std::uint32_t>(pending) >= slab->used)) {
+                collectRemote(slab);
+                if (slab->used == 0) {
+                    unlink(slab);
+                    releaseSlab(slab);
+                }
+            }
+            slab = next;
+        }
+    }
+
+    static bool hasFree(const SlabHeader* slab) {
+        return slab->localFree != nullptr || slab->carved < slab->capacity ||
+               slab->remoteFree.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    // Move up to `want` objects from `slab` into the magazine.
+    std::size_t take(SlabHeader* slab, Magazine& m, std::size_t want) {
+        std::size_t n = 0;
+        if (slab->localFree == nullptr) {
+            collectRemote(slab);
+        }
+        while (n < want && slab->localFree != nullptr) {
+            m.items[m.count++] = slab->localFree;
+            slab->localFree = slab->localFree->next;
+            ++n;
+        }
+        while (n < want && slab->carved < slab->capacity) {
+            m.items[m.count++] = objectAt(slab, slab->carved++);
+            ++n;
+        }
+        slab->used += static_cast<std::uint32_t>(n);
+        return n;
+    }
+
+    bool refill(std::size_t c) {
+        Magazine& m = magazines_[c];
+        m.limit = slabMagazineCapacity(c);
+        const std::size_t want = m.limit / 2;
+        sweepRemote(c);
+        if (slabs_[c] != nullptr && take(slabs_[c], m, want) > 0) {
+            return true;
+        }
+        // The current slab is exhausted: find another one with free objects and make it current.
+        for (SlabHeader* slab = slabs_[c] != nullptr ? slabs_[c]->next : nullptr; slab != nullptr; slab = slab->next) {
+            if (hasFree(slab)) {
+                unlink(slab);
+                pushFront(slab);
+                return take(slab, m, want) > 0;
+            }
+        }
+        // An adopted orphan may still be full; it joins the list anyway and the next one is tried.
+        while (SlabHeader* slab = acquireSlab(c)) {
+            pushFront(slab);
+            if (take(slab, m, want) > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Return the `count` most recently cached objects of class `c` to their slabs.
+    void flush(std::size_t c, std::size_t count) {
+        sweepRemote(c);
+        Magazine& m = magazines_[c];
+        for (std::size_t i = 0; i < count; ++i) {
+            SlabFreeObject* object = static_cast<SlabFreeObject*>(m.items[--m.count]);
+            SlabHeader* slab = slabOf(object);
+            object->next = slab->localFree;
+            slab->localFree = object;
+            if (--slab->used == 0 && slab != slabs_[c]) {
+                unlink(slab);
+                releaseSlab(slab);
+            }
+        }
+    }
+
+    void pushFront(SlabHeader* slab) {
+        const std::size_t c = slab->sizeClass;
+        slab->prev = nullptr;
+        slab->next = slabs_[c];
+        if (slabs_[c] != nullptr) slabs_[c]->prev = slab;
+        slabs_[c] = slab;
+    }
+
+    void unlink(SlabHeader* slab) {
+        if (slab->prev != nullptr) slab->prev->next = slab->next; else slabs_[slab->sizeClass] = slab->next;
+        if (slab->next != nullptr) slab->next->prev = slab->prev;
+    }
+
+    SlabHeader* acquireSlab(std::size_t c) {
+        SlabHeader* slab = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(slabGlobalState.mutex);
+            if (slabGlobalState.orphans[c] != nullptr) {
+                slab = slabGlobalState.orphans[c];
+                slabGlobalState.orphans[c] = slab->next;
+                slab->owner.store(this, std::memory_order_relaxed);
+                return slab; // Keeps its objects; remote frees are collected by take()
+            }
+            if (slabGlobalState.emptyCache != nullptr) {
+                slab = slabGlobalState.emptyCache;
+                slabGlobalState.emptyCache = slab->next;
+                --slabGlobalState.emptyCount;
+            }
+        }
+        if (slab == nullptr) {
+            slab = static_cast<SlabHeader*>(slabMapAligned(kSlabBytes));
+            if (slab == nullptr) {
+                return nullptr;
+            }
+            slabGlobalState.stats.slabsMapped.fetch_add(1, std::memory_order_relaxed);
+        }
+        slab->owner.store(this, std::memory_order_relaxed);
+        slab->sizeClass = static_cast<std::uint32_t>(c);
+        slab->capacity = static_cast<std::uint32_t>((kSlabBytes - kSlabHeaderBytes) / slabClassSize(c));
+        slab->carved = 0;
+        slab->used = 0;
+        slab->localFree = nullptr;
+        slab->next = slab->prev = nullptr;
+        slab->remoteFree.store(nullptr, std::memory_order_relaxed);
+        slab->remotePending.store(0, std::memory_order_relaxed);
+        return slab;
+    }
+
+    // Give an empty slab back: cache it with its pages released, or unmap it.
+    static void releaseSlab(SlabHeader* slab) {
+        {
+            std::lock_guard<std::mutex> lock(slabGlobalState.mutex);
+            if (slabGlobalState.emptyCount < kSlabCacheLimit) {
+                // Keep the header page (it links the cache); everything after it goes back to the OS.
+                madvise(reinterpret_cast<char*>(slab) + kSlabPageBytes, kSlabBytes - kSlabPageBytes, MADV_DONTNEED);
+                slab->owner.store(nullptr, std::memory_order_relaxed);
+                slab->next = slabGlobalState.emptyCache;
+                slabGlobalState.emptyCache = slab;
+                ++slabGlobalState.emptyCount;
+                slabGlobalState.stats.slabsCachedEmpty.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        munmap(slab, kSlabBytes);
+        slabGlobalState.stats.slabsUnmapped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void orphan(SlabHeader* slab) {
+        std::lock_guard<std::mutex> lock(slabGlobalState.mutex);
+        slab->owner.store(nullptr, std::memory_order_relaxed);
+        slab->next = slabGlobalState.orphans[slab->sizeClass];
+        slabGlobalState.orphans[slab->sizeClass] = slab;
+    }
+
+    Magazine magazines_[kSlabSizeClassCount];
+    SlabHeader* slabs_[kSlabSizeClassCount]; // Per-class list, the head is the current slab
+    std::uint32_t sweepTicks_[kSlabSizeClassCount];
+};
+
+// Per-thread heap lifecycle: not created yet, live, or torn down (during thread/program exit).
+enum : unsigned char { kSlabHeapUnused = 0, kSlabHeapLive = 1, kSlabHeapDead = 2 };
+thread_local unsigned char slabHeapState = kSlabHeapUnused;
+
+struct SlabHeapHolder {
+    SlabThreadHeap heap;
+    ~SlabHeapHolder() {
+        slabHeapState = kSlabHeapDead;
+        heap.teardown();
+    }
+};
+
+SlabHeapHolder& slabHeapHolder() {
+    static thread_local SlabHeapHolder holder; // Zero-initialized, no allocation
+    return holder;
+}
+
+// The calling thread's heap, or nullptr once it has been torn down.
+SlabThreadHeap* currentSlabHeap() {
+    if (slabHeapState == kSlabHeapDead) {
+        return nullptr;
+    }
+    slabHeapState = kSlabHeapLive;
+    return &slabHeapHolder().heap;
+}
+
+//------------------------------------------------------------------------------
+// Section 4: Public Interface
+//------------------------------------------------------------------------------
+
+/*
+ * Function: slabAllocate()
+ *
+ * Purpose: Allocate `bytes` aligned to `alignment` (a power of two). Alignments up to
+ *          kSlabMaxClassAlignment come from a size class whose objects are naturally aligned (the size is
+ *          rounded up to a multiple of the alignment); only larger ones need a dedicated mapping.
+ * Returns: nullptr if memory could not be mapped.
+ */
+void* slabAllocate(std::size_t bytes, std::size_t alignment = kSlabMinAlignment) {
+    if (bytes <= kSlabMaxSmallSize && alignment <= kSlabMaxClassAlignment) {
+        if (SlabThreadHeap* heap = currentSlabHeap()) {
+            return heap->allocate(alignment <= kSlabMinAlignment ? slabSizeClass(bytes)
+                                                                 : slabAlignedSizeClass(bytes, alignment));
+        }
+    }
+    return slabAllocateLarge(bytes, alignment);
+}
+
+/*
+ * Function: slabDeallocate()
+ *
+ * Purpose: Free memory from slabAllocate(), from any thread.
+ */
+void slabDeallocate(void* p) {
+    if (p == nullptr) {
+        return;
+    }
+    SlabHeader* slab = slabOf(p);
+    if (slab->sizeClass == kSlabLargeClass) {
+        munmap(slab, slab->mappingBytes);
+        return;
+    }
+    SlabThreadHeap* heap = currentSlabHeap();
+    if (heap != nullptr && slab->owner.load(std::memory_order_relaxed) == heap) {
+        heap->deallocateLocal(slab, p);
+        return;
+    }
+    // Remote free: push onto the owner's lock-free stack. Counted first: once the push lands, the owner
+    // may drain and release the slab, so the slab must not be touched after the CAS.
+    slab->remotePending.fetch_add(1, std::memory_order_relaxed);
+    SlabFreeObject* object = static_cast<SlabFreeObject*>(p);
+    SlabFreeObject* head = slab->remoteFree.load(std::memory_order_relaxed);
+    do {
+        object->next = head;
+    } while (!slab->remoteFree.compare_exchange_weak(head, object, std::memory_order_release,
+                                                     std::memory_order_relaxed));
+    slabGlobalState.stats.remoteFrees.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Usable bytes at `p` (the size class, or the rest of a large mapping).
+std::size_t slabUsableSize(const void* p) {
+    const SlabHeader* slab = slabOf(p);
+    if (slab->sizeClass == kSlabLargeClass) {
+        return slab->mappingBytes - static_cast<std::size_t>(static_cast<const char*>(p) - reinterpret_cast<const char*>(slab));
+    }
+    return slabClassSize(slab->sizeClass);
+}
+
+const SlabStats& slabStats() {
+    return slabGlobalState.stats;
+}
+
+/*
+ * Class: SlabMemoryResource
+ *
+ * Description: std::pmr front end; all instances share the same per-thread heaps and compare equal.
+ */
+class SlabMemoryResource : public std::pmr::memory_resource {
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* p = slabAllocate(bytes, alignment);
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t, std::size_t) override {
+        slabDeallocate(p);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return dynamic_cast<const SlabMemoryResource*>(&other) != nullptr;
+    }
+};
+
+SlabMemoryResource* slabMemoryResource() {
+    static SlabMemoryResource resource;
+    return &resource;
+}
+
+/*
+ * Class: SlabAllocator<T>
+ *
+ * Description: Stateless standard allocator over slabAllocate(), the multithreaded counterpart of
+ *              SimpleAllocator<T>: any instance can free memory allocated by any other, on any thread.
+ */
+template <typename T>
+class SlabAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    SlabAllocator() noexcept = default;
+
+    template <typename U>
+    SlabAllocator(const SlabAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t numObjects) {
+        if (numObjects > static_cast<std::size_t>(-1) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        void* p = slabAllocate(numObjects * sizeof(T), alignof(T));
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        slabDeallocate(p);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const SlabAllocator<T>&, const SlabAllocator<U>&) noexcept { return true; }
+
+template <typename T, typename U>
+bool operator!=(const SlabAllocator<T>&, const SlabAllocator<U>&) noexcept { return false; }
+
+//------------------------------------------------------------------------------
+// Section 5: Optional Global operator new/delete Hook
+//------------------------------------------------------------------------------
+
+#ifdef SLABALLOCATOR_GLOBAL_NEW
+void* operator new(std::size_t bytes) {
+    void* p = slabAllocate(bytes);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t bytes) { return ::operator new(bytes); }
+void* operator new(std::size_t bytes, const std::nothrow_t&) noexcept { return slabAllocate(bytes); }
+void* operator new[](std::size_t bytes, const std::nothrow_t&) noexcept { return slabAllocate(bytes); }
+void* operator new(std::size_t bytes, std::align_val_t alignment) {
+    void* p = slabAllocate(bytes, static_cast<std::size_t>(alignment));
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t bytes, std::align_val_t alignment) { return ::operator new(bytes, alignment); }
+void* operator new(std::size_t bytes, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return slabAllocate(bytes, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t bytes, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return slabAllocate(bytes, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* p) noexcept { slabDeallocate(p); }
+void operator delete[](void* p) noexcept { slabDeallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { slabDeallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { slabDeallocate(p); }
+void operator delete(void* p, std::align_val_t) noexcept { slabDeallocate(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { slabDeallocate(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { slabDeallocate(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { slabDeallocate(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { slabDeallocate(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { slabDeallocate(p); }
+#endif // SLABALLOCATOR_GLOBAL_NEW
+
+//------------------------------------------------------------------------------
+// Section 6: Multithreaded Benchmark and Demonstration
+//------------------------------------------------------------------------------
+
+/*
+ * Function: slabAllocatorWorkload()
+ *
+ * Purpose: Each thread keeps a window of `window` live objects of random size (16-1024 bytes) and
+ *          replaces a random one per operation. At the end every thread frees the window of its neighbour,
+ *          so a share of the frees is cross-thread.
+ * Returns: million operations per second over all threads.
+ */
+template <typename Allocate, typename Free>
+double slabAllocatorWorkload(unsigned threads, std::size_t opsPerThread, std::size_t window,
+                             Allocate allocate, Free release) {
+    std::vector<std::vector<void*>> windows(threads, std::vector<void*>(window, nullptr));
+    std::atomic<unsigned> finished{0};
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937 gen(t + 1);
+            std::vector<void*>& mine = windows[t];
+            for (std::size_t i = 0; i < opsPerThread; ++i) {
+                const std::size_t slot = gen() % window;
+                release(mine[slot]);
+                const std::size_t bytes = 16u << (gen() % 7); // 16..1024, log-uniform
+                mine[slot] = allocate(bytes);
+                static_cast<char*>(mine[slot])[0] = static_cast<char>(i);
+            }
+            finished.fetch_add(1);
+            while (finished.load() < threads) {
+                std::this_thread::yield();
+            }
+            for (void*& p : windows[(t + 1) % threads]) {
+                release(p);
+                p = nullptr;
+            }
+        });
+    }
+    for (std::thread& w : workers) {
+        w.join();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return threads * static_cast<double>(opsPerThread + window) / seconds / 1e6;
+}
+
+void benchmarkSlabAllocator(std::size_t opsPerThread) {
+    const unsigned cores = std::thread::hardware_concurrency();
+    std::cout << "Alloc/free throughput (" << cores << " hardware thread(s)):\n";
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        const double heap = slabAllocatorWorkload(threads, opsPerThread, 4096,
+            [](std::size_t n) { return std::malloc(n); }, [](void* p) { std::free(p); });
+        const double slab = slabAllocatorWorkload(threads, opsPerThread, 4096,
+            [](std::size_t n) { return slabAllocate(n); }, [](void* p) { slabDeallocate(p); });
+        std::cout << "  " << threads << " thread(s): malloc " << heap << " Mops/s (" << heap / threads
+                  << " per thread), slab " << slab << " Mops/s (" << slab / threads << " per thread)\n";
+    }
+}
+
+void runSlabAllocatorExamples() {
+    std::cout << "\n--- Size-Class Slab Allocator ---\n";
+#ifdef SLABALLOCATOR_GLOBAL_NEW
+    std::cout << "Global operator new/delete are routed through the slab allocator.\n";
+#endif
+
+    std::pmr::vector<std::pmr::string> words(slabMemoryResource());
+    for (const char* w : {"slab", "magazine", "remote free queue", "size class"}) {
+        words.emplace_back(w);
+    }
+    std::cout << "pmr vector on SlabMemoryResource: ";
+    for (const auto& w : words) {
+        std::cout << w << " | ";
+    }
+    std::cout << "\nVector buffer of " << words.capacity() * sizeof(std::pmr::string) << " bytes lives in the "
+              << slabUsableSize(words.data()) << "-byte size class\n";
+
+    // SimpleAllocator-style front end for standard containers
+    std::vector<int, SlabAllocator<int>> numbers;
+    for (int i = 0; i < 1000; ++i) {
+        numbers.push_back(i);
+    }
+    std::cout << "std::vector<int, SlabAllocator<int>> with " << numbers.size() << " elements, capacity "
+              << numbers.capacity() << " (" << slabUsableSize(numbers.data()) << " usable bytes)\n";
+
+    benchmarkSlabAllocator(500000);
+
+    const SlabStats& stats = slabStats();
+    std::cout << "Slabs mapped: " << stats.slabsMapped << ", released to cache (pages returned): "
+              << stats.slabsCachedEmpty << ", unmapped: " << stats.slabsUnmapped
+              << ", remote frees: " << stats.remoteFrees << "\n";
+}
+
+#endif // SLABALLOCATOR_H
@@ -0,0 +1,335 @@
+#ifndef SLOTPOOL_H
+#define SLOTPOOL_H
+
+#include <iostream>       // For standard input/output operations (cout)
+#include <memory>         // For shared_ptr/weak_ptr in the comparison benchmark
+#include <vector>         // For dense object storage and the slot table
+#include <utility>        // For std::forward, std::move
+#include <cstdint>        // For fixed-width handle fields
+#include <cstddef>        // For std::size_t
+#include <chrono>         // For timing the benchmarks
+#include <random>         // For random lookups and destruction order
+#include <algorithm>      // For std::shuffle
+#include <iomanip>        // For benchmark table formatting
+
+#include "SmartPointersAndMemory.h" // For MyClass
+
+//------------------------------------------------------------------------------
+// Section 1: Generational Handles Instead of shared_ptr/weak_ptr
+//------------------------------------------------------------------------------
+
+/*
+ * What does a shared_ptr cost?
+ * - make_shared<MyClass>() is a heap allocation holding a control block (two atomic counters and a
+ *   vtable pointer) next to the object; every copy and destruction is an atomic increment/decrement,
+ *   and weak_ptr::lock() is a compare-and-swap loop on the use count.
+ * - Objects live wherever the heap put them, so walking a vector<shared_ptr<T>> chases one pointer per
+ *   element into scattered memory.
+ *
+ * SlotPool<T> instead:
+ * - Stores live objects contiguously in a dense array. Destroying an object moves the last one into
+ *   its place (swap-remove), so iteration is always over a packed range.
+ * - Hands out SlotHandle, a 64-bit value: a 32-bit slot index plus a 32-bit generation. The slot table
+ *   maps the index to the object's current dense position.
+ * - Bumps a slot's generation when its object is destroyed. A handle whose generation no longer matches
+ *   is stale: get() returns nullptr, which is the weak_ptr::lock() check without atomics or a control block.
+ * - Recycles free slots through an intrusive free list, so create() and destroy() are O(1). A slot whose
+ *   generation would wrap around is retired rather than reused, so a stale handle can never come back to life.
+ *
+ * Ownership is explicit: the pool owns every object and destroy() ends its life. Pointers returned by
+ * get() are valid until the next create() or destroy(); store handles, not pointers.
+ */
+
+class SlotHandle {
+public:
+    SlotHandle() = default;
+    SlotHandle(std::uint32_t index, std::uint32_t generation)
+        : value_(static_cast<std::uint64_t>(generation) << 32 | index) {}
+
+    std::uint32_t index() const { return static_cast<std::uint32_t>(value_); }
+    std::uint32_t generation() const { return static_cast<std::uint32_t>(value_ >> 32); }
+
+    // Raw 64-bit form, e.g. for storing handles in other records.
+    std::uint64_t value() const { return value_; }
+    static SlotHandle fromValue(std::uint64_t value) {
+        SlotHandle h;
+        h.value_ = value;
+        return h;
+    }
+
+    // Generations start at 1, so a default-constructed handle never refers to an object.
+    explicit operator bool() const { return generation() != 0; }
+
+    bool operator==(const SlotHandle& other) const { return value_ == other.value_; }
+    bool operator!=(const SlotHandle& other) const { return value_ != other.value_; }
+
+private:
+    std::uint64_t value_ = 0;
+};
+
+const std::uint32_t kSlotPoolNoSlot = 0xFFFFFFFFu;
+
+/*
+ * Class: SlotPool<T>
+ *
+ * Description: Dense, handle-addressed storage for objects of type T (which must be move-assignable).
+ *              Not thread-safe; use one pool per thread or guard it externally.
+ */
+template <typename T>
+class SlotPool {
+public:
+    explicit SlotPool(std::size_t capacity = 0) { reserve(capacity); }
+
+    void reserve(std::size_t capacity) {
+        slots_.reserve(capacity);
+        objects_.reserve(capacity);
+        owners_.reserve(capacity);
+    }
+
+    template <typename... Args>
+    SlotHandle create(Args&&... args) {
+        std::uint32_t index;
+        if (freeHead_ != kSlotPoolNoSlot) {
+            index = freeHead_;
+            freeHead_ = slots_[index].link;
+        } else {
+            index = static_cast<std::uint32_t>(slots_.size());
+            slots_.push_back(Slot{1, kSlotPoolNoSlot});
+        }
+        try {
+            objects_.emplace_back(std::forward<Args>(args)...);
+            owners_.push_back(index);
+        } catch (...) {
+            if (objects_.size() > owners_.size()) {
+                objects_.pop_back();
+            }
+            slots_[index].link = freeHead_; // Give the slot back unchanged; no handle was issued
+            freeHead_ = index;
+            throw;
+        }
+        slots_[index].link = static_cast<std::uint32_t>(objects_.size() - 1);
+        return SlotHandle(index, slots_[index].generation);
+    }
+
+    // True if `handle` refers to a live object of this pool.
+    bool contains(SlotHandle handle) const {
+        return handle.index() < slots_.size() && handle.generation() != 0 &&
+               slots_[handle.index()].generation == handle.generation();
+    }
+
+    // The object, or nullptr if the handle is stale or null.
+    T* get(SlotHandle handle) {
+        return contains(handle) ? &objects_[slots_[handle.index()].link] : nullptr;
+    }
+
+    const T* get(SlotHandle handle) const {
+        return contains(handle) ? &objects_[slots_[handle.index()].link] : nullptr;
+    }
+
+    /*
+     * Function: destroy()
+     *
+     * Purpose: End the life of the object behind `handle` and invalidate every copy of the handle.
+     * Returns: false if the handle was already stale.
+     */
+    bool destroy(SlotHandle handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+        Slot& slot = slots_[handle.index()];
+        const std::uint32_t hole = slot.link;
+        const std::uint32_t last = static_cast<std::uint32_t>(objects_.size() - 1);
+        if (hole != last) {
+            objects_[hole] = std::move(objects_[last]);
+            owners_[hole] = owners_[last];
+            slots_[owners_[hole]].link = hole;
+        }
+        objects_.pop_back();
+        owners_.pop_back();
+        retireSlot(handle.index());
+        return true;
+    }
+
+    void clear() {
+        for (std::uint32_t index : owners_) {
+            retireSlot(index);
+        }
+        objects_.clear();
+        owners_.clear();
+    }
+
+    std::size_t size() const { return objects_.size(); }
+    bool empty() const { return objects_.empty(); }
+
+    // Dense iteration over live objects (order changes when objects are destroyed).
+    T* begin() { return objects_.data(); }
+    T* end() { return objects_.data() + objects_.size(); }
+    const T* begin() const { return objects_.data(); }
+    const T* end() const { return objects_.data() + objects_.size(); }
+
+    // Handle of the object at dense position `i`, e.g. to destroy objects found while iterating.
+    SlotHandle handleAt(std::size_t i) const {
+        return SlotHandle(owners_[i], slots_[owners_[i]].generation);
+    }
+
+    // Bytes of pool bookkeeping per live object (slot entry + dense owner index), excluding T itself.
+    static constexpr std::size_t overheadBytesPerObject() { return sizeof(Slot) + sizeof(std::uint32_t); }
+
+private:
+    struct Slot {
+        std::uint32_t generation; // 0 = retired for good
+        std::uint32_t link;       // Dense index while live, next free slot while free
+    };
+
+    void retireSlot(std::uint32_t index) {
+        Slot& slot = slots_[index];
+        if (++slot.generation == 0) {
+            return; // Generation exhausted: never hand this slot out again
+        }
+        slot.link = freeHead_;
+        freeHead_ = index;
+    }
+
+    std::vector<Slot> slots_;
+    std::vector<T> objects_;                 // Live objects, packed
+    std::vector<std::uint32_t> owners_;      // Slot index of each dense object
+    std::uint32_t freeHead_ = kSlotPoolNoSlot;
+};
+
+//------------------------------------------------------------------------------
+// Section 2: Benchmarks Against shared_ptr/weak_ptr
+//------------------------------------------------------------------------------
+
+// A MyClass-sized stand-in that does not print: position, velocity and an id.
+struct SlotPoolBody {
+    float x = 0, y = 0, z = 0;
+    float vx = 1, vy = 2, vz = 3;
+    std::uint32_t id = 0;
+
+    SlotPoolBody() = default;
+    explicit SlotPoolBody(std::uint32_t i) : id(i) {}
+    void step(float dt) { x += vx * dt; y += vy * dt; z += vz * dt; }
+};
+
+/*
+ * Function: benchmarkSlotPool()
+ *
+ * Purpose: Same workload both ways: create `count` objects, look each up through a weak reference /
+ *          handle in random order, update all of them in a batch, destroy them in random order, and
+ *          finally check that all references went stale.
+ */
+void benchmarkSlotPool(std::size_t count) {
+    using Clock = std::chrono::steady_clock;
+    auto ms = [](Clock::time_point since) { return std::chrono::duration<double, std::milli>(Clock::now() - since).count(); };
+    std::mt19937 gen(11);
+    std::vector<std::uint32_t> order(count);
+    for (std::uint32_t i = 0; i < count; ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), gen);
+    float checksum = 0;
+
+    // shared_ptr owners + weak_ptr observers
+    auto start = Clock::now();
+    std::vector<std::shared_ptr<SlotPoolBody>> owners;
+    std::vector<std::weak_ptr<SlotPoolBody>> observers;
+    owners.reserve(count);
+    observers.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        owners.push_back(std::make_shared<SlotPoolBody>(i));
+        observers.push_back(owners.back());
+    }
+    const double sharedCreate = ms(start);
+    start = Clock::now();
+    for (std::uint32_t i : order) {
+        if (auto p = observers[i].lock()) checksum += p->x + static_cast<float>(p->id);
+    }
+    const double sharedLookup = ms(start);
+    start = Clock::now();
+    for (int round = 0; round < 10; ++round) {
+        for (const auto& p : owners) p->step(0.01f);
+    }
+    const double sharedIterate = ms(start);
+    start = Clock::now();
+    for (std::uint32_t i : order) owners[i].reset();
+    std::size_t sharedStale = 0;
+    for (const auto& w : observers) sharedStale += w.expired();
+    const double sharedDestroy = ms(start);
+
+    // SlotPool + handles
+    start = Clock::now();
+    SlotPool<SlotPoolBody> pool(count);
+    std::vector<SlotHandle> handles;
+    handles.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        handles.push_back(pool.create(i));
+    }
+    const double poolCreate = ms(start);
+    start = Clock::now();
+    for (std::uint32_t i : order) {
+        if (SlotPoolBody* p = pool.get(handles[i])) checksum += p->x + static_cast<float>(p->id);
+    }
+    const double poolLookup = ms(start);
+    start = Clock::now();
+    for (int round = 0; round < 10; ++round) {
+        for (SlotPoolBody& b : pool) b.step(0.01f);
+    }
+    const double poolIterate = ms(start);
+    start = Clock::now();
+    for (std::uint32_t i : order) pool.destroy(handles[i]);
+    std::size_t poolStale = 0;
+    for (SlotHandle h : handles) poolStale += !pool.contains(h);
+    const double poolDestroy = ms(start);
+
+    // make_shared puts the object after a 16-byte control block; each owner and observer is 16 bytes.
+    const std::size_t sharedBytes = sizeof(SlotPoolBody) + 16 + sizeof(std::shared_ptr<SlotPoolBody>) +
+                                    sizeof(std::weak_ptr<SlotPoolBody>);
+    const std::size_t poolBytes = sizeof(SlotPoolBody) + SlotPool<SlotPoolBody>::overheadBytesPerObject() +
+                                  sizeof(SlotHandle);
+    auto row = [](const char* label, double create, double lookup, double iterate, double destroy) {
+        std::cout << label << std::fixed << std::setprecision(1) << std::setw(9) << create << std::setw(9) << lookup
+                  << std::setw(13) << iterate << std::setw(9) << destroy;
+    };
+    std::cout << count << " objects, ms:    create   lookup  10x iterate  destroy  bytes/object\n";
+    row("  shared/weak_ptr ", sharedCreate, sharedLookup, sharedIterate, sharedDestroy);
+    std::cout << "  " << sharedBytes << " + malloc header\n";
+    row("  SlotPool/handle ", poolCreate, poolLookup, poolIterate, poolDestroy);
+    std::cout << "  " << poolBytes << "\n" << std::defaultfloat
+              << "  stale references detected: " << sharedStale << " / " << poolStale
+              << " (checksum " << checksum << ")\n";
+}
+
+//------------------------------------------------------------------------------
+// Section 3: Demonstration
+//------------------------------------------------------------------------------
+
+void runSlotPoolExamples() {
+    std::cout << "\n--- Generational-Handle Object Pool ---\n";
+
+    // The runSmartPointersAndMemory() walkthrough, with a pool owning the MyClass objects
+    SlotPool<MyClass> pool(4);
+    SlotHandle first = pool.create();
+    SlotHandle second = pool.create();
+    SlotHandle copy = first; // Copying a handle is copying an integer: no reference count
+    if (MyClass* object = pool.get(copy)) {
+        object->greet();
+    }
+    std::cout << "Live objects: " << pool.size() << ", handle " << std::hex << first.value() << std::dec
+              << " = slot " << first.index() << ", generation " << first.generation() << "\n";
+
+    pool.destroy(first);
+    if (pool.get(copy) == nullptr) { // Replaces weak_ptr::lock()
+        std::cout << "Handle is stale: the object was destroyed.\n";
+    }
+    SlotHandle reused = pool.create(); // Reuses slot 0 with the next generation
+    std::cout << "New object in slot " << reused.index() << ", generation " << reused.generation()
+              << "; old handle still stale: " << std::boolalpha << !pool.contains(copy) << std::noboolalpha << "\n";
+    const bool destroyedOnce = pool.destroy(second);
+    const bool destroyedTwice = pool.destroy(second);
+    std::cout << "Destroying the same handle twice: " << (destroyedOnce ? "ok" : "rejected") << ", "
+              << (destroyedTwice ? "ok" : "rejected") << "\n";
+    pool.clear();
+
+    std::cout << "\n";
+    benchmarkSlotPool(1000000);
+}
+
+#endif // SLOTPOOL_H
@@ -4,6 +4,7 @@
 #include <iostream>       // For input/output operations (e.g., printing to the console)
 #include <memory>         // For smart pointer classes (unique_ptr, shared_ptr, weak_ptr)
 #include <vector>         // For demonstrating smart pointers in a container scenario
+#include "PoolAllocator.h" // For make_pooled_shared
 
 
 //------------------------------------------------------------------------------
@@ -76,7 +77,7 @@ void runSmartPointersAndMemory() {
 
     std::cout << "\n--- shared_ptr Example ---\n";
     // Shared Pointer Example
-    std::shared_ptr<MyClass> sptr1 = std::make_shared<MyClass>();
+    std::shared_ptr<MyClass> sptr1 = make_pooled_shared<MyClass>(); // Like make_shared, but object and control block come from a pool
     std::shared_ptr<MyClass> sptr2 = sptr1;  // Create another shared_ptr, both pointing to the same MyClass object
 
     sptr1->greet();
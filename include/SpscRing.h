@@ -0,0 +1,266 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <iostream>       // For standard input/output operations (cout)
+#include <atomic>         // For the head and tail indices
+#include <thread>         // For the benchmark threads
+#include <new>            // For placement new
+#include <type_traits>    // For std::aligned_storage
+#include <utility>        // For std::move, std::forward
+#include <algorithm>      // For std::min
+#include <cstdint>        // For std::uint64_t
+#include <cstddef>        // For std::size_t
+#include <chrono>         // For timing the benchmarks
+#include "CpuFeatures.h"  // For cpuRelax
+#include "MpmcQueue.h"    // For the MPMC comparison in the benchmark
+
+//------------------------------------------------------------------------------
+// Section 1: SpscRing<T, N>
+//------------------------------------------------------------------------------
+
+/*
+ * Why a dedicated single-producer/single-consumer ring?
+ * - With exactly one writer per index no read-modify-write is needed: the producer alone advances
+ *   tail_, the consumer alone advances head_, and each publishes with a plain release store. Every
+ *   operation finishes in a bounded number of steps (wait-free).
+ * - head_ and tail_ live on separate cache lines, so the two threads do not invalidate each other's
+ *   line on every operation (false sharing).
+ * - Each side keeps a private copy of the other side's index and re-reads the shared one only when the
+ *   copy says the ring is full (producer) or empty (consumer). In steady state most operations touch
+ *   only the side's own line plus the slot itself.
+ * - try_push_n()/try_pop_n() move a whole batch with one index check and one index store.
+ * - N must be a power of two so that positions map to slots with a mask; indices are free-running
+ *   64-bit counters and never wrap in practice.
+ */
+template <typename T, std::size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    SpscRing() = default;
+
+    ~SpscRing() {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        for (std::size_t pos = head_.load(std::memory_order_relaxed); pos != tail; ++pos) {
+            slot(pos)->~T();
+        }
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer only.
+    template <typename U>
+    bool try_push(U&& value) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ == N) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ == N) {
+                return false;
+            }
+        }
+        new (slot(tail)) T(std::forward<U>(value));
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer only: pushes the first k of `count` items that fit; returns k.
+    std::size_t try_push_n(const T* items, std::size_t count) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (N - (tail - cachedHead_) < count) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+        }
+        const std::size_t n = std::min(count, N - (tail - cachedHead_));
+        for (std::size_t i = 0; i < n; ++i) {
+            new (slot(tail + i)) T(items[i]);
+        }
+        if (n > 0) {
+            tail_.store(tail + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // Consumer only.
+    bool try_pop(T& out) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) {
+                return false;
+            }
+        }
+        T* item = slot(head);
+        out = std::move(*item);
+        item->~T();
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only: pops up to `maxCount` items into `out`; returns how many.
+    std::size_t try_pop_n(T* out, std::size_t maxCount) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (cachedTail_ - head < maxCount) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+        }
+        const std::size_t n = std::min(maxCount, cachedTail_ - head);
+        for (std::size_t i = 0; i < n; ++i) {
+            T* item = slot(head + i);
+            out[i] = std::move(*item);
+            item->~T();
+        }
+        if (n > 0) {
+            head_.store(head + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    static constexpr std::size_t capacity() { return N; }
+
+    // Exact from either side when the other side is idle; approximate otherwise.
+    std::size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+private:
+    T* slot(std::size_t pos) { return reinterpret_cast<T*>(&slots_[pos & (N - 1)]); }
+
+    // Producer's line: its index and its copy of the consumer's.
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    std::size_t cachedHead_ = 0;
+    // Consumer's line.
+    alignas(64) std::atomic<std::size_t> head_{0};
+    std::size_t cachedTail_ = 0;
+    alignas(64) typename std::aligned_storage<sizeof(T), alignof(T)>::type slots_[N];
+};
+
+//------------------------------------------------------------------------------
+// Section 2: Benchmarks - Throughput and Ping-Pong Latency
+//------------------------------------------------------------------------------
+
+// Spin briefly for `ready`, then yield so the other thread can run if it shares our core.
+template <typename Ready>
+void spscSpinUntil(Ready ready) {
+    for (int spin = 0; !ready(); ++spin) {
+        if (spin < 128) {
+            cpuRelax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/*
+ * Function: spscThroughput()
+ *
+ * Purpose: Stream `items` integers from one thread to another through SpscRing, one at a time
+ *          (batch == 1) or with try_push_n/try_pop_n; millions of items per second.
+ */
+template <std::size_t Batch>
+double spscThroughput(std::size_t items) {
+    SpscRing<std::uint64_t, 4096>* ring = new SpscRing<std::uint64_t, 4096>();
+    std::uint64_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    std::thread consumer([&] {
+        std::uint64_t buffer[Batch];
+        std::size_t received = 0;
+        while (received < items) {
+            std::size_t n = 0;
+            spscSpinUntil([&] { return (n = Batch == 1 ? ring->try_pop(buffer[0]) : ring->try_pop_n(buffer, Batch)) != 0; });
+            for (std::size_t i = 0; i < n; ++i) {
+                checksum += buffer[i];
+            }
+            received += n;
+        }
+    });
+    std::uint64_t buffer[Batch];
+    for (std::size_t sent = 0; sent < items;) {
+        const std::size_t want = std::min(Batch, items - sent);
+        for (std::size_t i = 0; i < want; ++i) {
+            buffer[i] = sent + i;
+        }
+        std::size_t done = 0;
+        while (done < want) {
+            std::size_t n = 0;
+            spscSpinUntil([&] {
+                return (n = Batch == 1 ? ring->try_push(buffer[0]) : ring->try_push_n(buffer + done, want - done)) != 0;
+            });
+            done += n;
+        }
+        sent += want;
+    }
+    consumer.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    delete ring;
+    return checksum == std::uint64_t(items) * (items - 1) / 2 ? items / seconds / 1e6 : 0.0;
+}
+
+double mpmcPairThroughput(std::size_t items) {
+    MpmcQueue<std::uint64_t> queue(4096);
+    std::uint64_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    std::thread consumer([&] {
+        std::uint64_t value;
+        for (std::size_t received = 0; received < items; ++received) {
+            spscSpinUntil([&] { return queue.try_pop(value); });
+            checksum += value;
+        }
+    });
+    for (std::size_t i = 0; i < items; ++i) {
+        spscSpinUntil([&] { return queue.try_push(std::uint64_t(i)); });
+    }
+    consumer.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return checksum == std::uint64_t(items) * (items - 1) / 2 ? items / seconds / 1e6 : 0.0;
+}
+
+// Round trip: A pushes to `ping`, B echoes it back through `pong`; nanoseconds per round trip.
+double spscPingPongNs(std::size_t roundTrips) {
+    SpscRing<std::uint64_t, 8> ping;
+    SpscRing<std::uint64_t, 8> pong;
+    std::thread echo([&] {
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < roundTrips; ++i) {
+            spscSpinUntil([&] { return ping.try_pop(value); });
+            pong.try_push(value + 1);
+        }
+    });
+    const auto start = std::chrono::steady_clock::now();
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < roundTrips; ++i) {
+        ping.try_push(value);
+        spscSpinUntil([&] { return pong.try_pop(value); });
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    echo.join();
+    return value == roundTrips ? ns / roundTrips : 0.0;
+}
+
+//------------------------------------------------------------------------------
+// Section 3: Demonstration
+//------------------------------------------------------------------------------
+
+void runSpscRingExamples() {
+    std::cout << "\n--- Wait-Free SPSC Ring ---\n";
+    SpscRing<int, 8> ring;
+    const int batch[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    std::cout << "try_push_n(10 items) into capacity " << ring.capacity() << ": pushed " << ring.try_push_n(batch, 10)
+              << "\n";
+    int out[4];
+    const std::size_t popped = ring.try_pop_n(out, 4);
+    std::cout << "try_pop_n(4):";
+    for (std::size_t i = 0; i < popped; ++i) {
+        std::cout << " " << out[i];
+    }
+    std::cout << ", " << ring.size() << " left\n";
+
+    const std::size_t items = 20000000;
+    std::cout << "Streaming " << items << " integers between two threads:\n"
+              << "  SpscRing, single items      " << spscThroughput<1>(items) << " M/s\n"
+              << "  SpscRing, batches of 64     " << spscThroughput<64>(items) << " M/s\n"
+              << "  MpmcQueue, single items     " << mpmcPairThroughput(items) << " M/s\n";
+    std::cout << "Ping-pong round trip: " << spscPingPongNs(200000) << " ns"
+              << (std::thread::hardware_concurrency() < 2 ? " (one hardware thread: includes a context switch)" : "")
+              << "\n";
+}
+
+#endif // SPSCRING_H
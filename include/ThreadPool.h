@@ -0,0 +1,561 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <iostream>       // For standard input/output operations (cout)
+#include <thread>         // For the worker threads
+#include <mutex>          // For the injection queue and parking
+#include <condition_variable> // For parking idle workers and wait_idle()
+#include <future>         // For std::packaged_task and std::future returned by submit()
+#include <atomic>         // For deque indices and pool counters
+#include <deque>          // For the injection queue fed by non-worker threads
+#include <vector>         // For the worker list
+#include <memory>         // For std::unique_ptr
+#include <tuple>          // For capturing submit() arguments
+#include <type_traits>    // For std::invoke_result_t, std::decay_t
+#include <stdexcept>      // For the demo's failing task
+#include <algorithm>      // For std::max, std::min
+#include <utility>        // For std::forward, std::move
+#include <cstdint>        // For std::int64_t, std::uint64_t
+#include <cstddef>        // For std::size_t
+#include <chrono>         // For the dispatch and scaling benchmarks
+
+// ThreadSanitizer does not model stand-alone fences, so sanitized builds use a read-modify-write instead.
+#if defined(__SANITIZE_THREAD__)
+#define THREADPOOL_TSAN 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define THREADPOOL_TSAN 1
+#endif
+#endif
+#ifndef THREADPOOL_TSAN
+#define THREADPOOL_TSAN 0
+#endif
+
+//------------------------------------------------------------------------------
+// Section 1: Chase-Lev Work-Stealing Deque
+//------------------------------------------------------------------------------
+
+/*
+ * Why a work-stealing pool?
+ * - Spawning a std::thread per task costs tens of microseconds (clone, stack mapping, join), which
+ *   dominates short tasks. A pool keeps its workers and hands them tasks instead.
+ * - A single shared queue becomes the bottleneck once tasks are short: every submit and every take
+ *   contends on one lock. Here each worker owns a deque:
+ *     - The owner pushes and pops at the bottom (LIFO: the most recently spawned, cache-hot task first)
+ *       with no read-modify-write except when taking the last element.
+ *     - Idle workers steal from the top of a randomly chosen victim (FIFO: the oldest, usually largest
+ *       piece of work), so the load spreads without a central queue.
+ * - Tasks submitted from outside the pool go to a small injection queue; a worker that takes from it
+ *   moves a batch into its own deque so the rest can be stolen.
+ *
+ * WorkStealingDeque<T> is the Chase-Lev deque (with the memory orders of Le et al., "Correct and
+ * Efficient Work-Stealing for Weak Memory Models", expressed as sequentially consistent operations
+ * rather than stand-alone fences). The circular buffer grows by doubling; old buffers stay alive until
+ * the deque is destroyed because a thief may still be reading from one.
+ */
+template <typename T>
+class WorkStealingDeque {
+    static_assert(std::is_pointer<T>::value, "WorkStealingDeque stores pointers (nullptr means empty)");
+
+public:
+    explicit WorkStealingDeque(std::int64_t capacity = 256) : buffer_(new Buffer(capacity)) {}
+    ~WorkStealingDeque() { delete buffer_.load(std::memory_order_relaxed); }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only.
+    void push(T item) {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t t = top_.load(std::memory_order_acquire);
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+        if (b - t > buffer->capacity - 1) {
+            buffer = grow(buffer, t, b);
+        }
+        buffer->put(b, item);
+        bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner only; nullptr when empty.
+    T pop() {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_seq_cst);
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T item = buffer->get(b);
+        if (t == b) {
+            // Last element: race the thieves for it.
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Any thread; nullptr when empty or when another thread won the race.
+    T steal() {
+        std::int64_t t = top_.load(std::memory_order_seq_cst);
+        const std::int64_t b = bottom_.load(std::memory_order_seq_cst);
+        if (t >= b) {
+            return nullptr;
+        }
+        Buffer* buffer = buffer_.load(std::memory_order_acquire);
+        T item = buffer->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    // Approximate when called concurrently with push/pop/steal.
+    std::int64_t size() const {
+        return std::max<std::int64_t>(0, bottom_.load(std::memory_order_relaxed) - top_.load(std::memory_order_relaxed));
+    }
+
+private:
+    struct Buffer {
+        explicit Buffer(std::int64_t cap) : capacity(cap), slots(new std::atomic<T>[static_cast<std::size_t>(cap)]) {}
+        T get(std::int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(std::int64_t i, T item) { slots[i & (capacity - 1)].store(item, std::memory_order_relaxed); }
+
+        std::int64_t capacity; // Power of two
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    Buffer* grow(Buffer* old, std::int64_t t, std::int64_t b) {
+        Buffer* bigger = new Buffer(old->capacity * 2);
+        for (std::int64_t i = t; i < b; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        retired_.emplace_back(old);
+        buffer_.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(64) std::atomic<std::int64_t> top_{0};
+    alignas(64) std::atomic<std::int64_t> bottom_{0};
+    std::atomic<Buffer*> buffer_;
+    std::vector<std::unique_ptr<Buffer>> retired_; // Owner only
+};
+
+//------------------------------------------------------------------------------
+// Section 2: ThreadPool
+//------------------------------------------------------------------------------
+
+struct ThreadPoolTask {
+    virtual ~ThreadPoolTask() = default;
+    virtual void run() = 0;
+};
+
+template <typename F>
+struct ThreadPoolTaskImpl final : ThreadPoolTask {
+    explicit ThreadPoolTaskImpl(F&& f) : fn(std::move(f)) {}
+    void run() override { fn(); }
+    F fn;
+};
+
+class ThreadPool;
+
+thread_local ThreadPool* threadPoolCurrent = nullptr; // Pool the calling thread works for, if any
+thread_local std::size_t threadPoolWorkerIndex = 0;
+
+const int kThreadPoolSpinRounds = 64;          // Yielding scans before a worker parks
+const std::size_t kThreadPoolInjectBatch = 32; // Tasks moved from the injection queue per visit
+
+struct ThreadPoolStats {
+    std::uint64_t executed = 0;
+    std::uint64_t stolen = 0;
+    std::uint64_t parks = 0;
+};
+
+/*
+ * Class: ThreadPool
+ *
+ * Description: Fixed set of workers with per-worker work-stealing deques.
+ *              - submit(f, args...) returns a std::future for f's result (exceptions included). Tasks
+ *                submitted by a pool task go to that worker's own deque; others to the injection queue.
+ *              - wait_idle() blocks until every submitted task, including tasks they submitted, is done.
+ *              - shutdown() stops accepting outside submissions, drains, and joins the workers; later
+ *                submit() calls return a future that throws std::future_error (broken_promise).
+ *              - Tasks must not wait on the future of another pool task, and wait_idle()/shutdown() must
+ *                not be called from a task: the waiting worker would not be free to run it.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t workers = std::thread::hardware_concurrency()) {
+        if (workers == 0) {
+            workers = 1;
+        }
+        for (std::size_t i = 0; i < workers; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+        for (std::size_t i = 0; i < workers; ++i) {
+            workers_[i]->thread = std::thread(&ThreadPool::workerLoop, this, i);
+        }
+    }
+
+    ~ThreadPool() { shutdown(); }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F, typename... Args>
+    std::future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>> submit(F&& f, Args&&... args) {
+        using Result = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+        std::packaged_task<Result()> task(
+            [fn = std::forward<F>(f), bound = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+                return std::apply(std::move(fn), std::move(bound));
+            });
+        std::future<Result> future = task.get_future();
+        enqueue(new ThreadPoolTaskImpl<std::packaged_task<Result()>>(std::move(task)));
+        return future;
+    }
+
+    void wait_idle() {
+        std::unique_lock<std::mutex> lock(idleMutex_);
+        idleWaiters_.fetch_add(1, std::memory_order_seq_cst);
+        idleCv_.wait(lock, [this] { return pending_.load(std::memory_order_seq_cst) == 0; });
+        idleWaiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void shutdown() {
+        std::lock_guard<std::mutex> guard(shutdownMutex_);
+        if (stopping_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        accepting_.store(false, std::memory_order_seq_cst);
+        wait_idle();
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stopping_.store(true, std::memory_order_release);
+            events_.fetch_add(1, std::memory_order_relaxed);
+        }
+        sleepCv_.notify_all();
+        for (std::unique_ptr<Worker>& w : workers_) {
+            if (w->thread.joinable()) {
+                w->thread.join();
+            }
+        }
+    }
+
+    std::size_t size() const { return workers_.size(); }
+
+    ThreadPoolStats stats() const {
+        ThreadPoolStats stats;
+        for (const std::unique_ptr<Worker>& w : workers_) {
+            stats.executed += w->executed.load(std::memory_order_relaxed);
+            stats.stolen += w->stolen.load(std::memory_order_relaxed);
+            stats.parks += w->parks.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+private:
+    struct alignas(64) Worker {
+        WorkStealingDeque<ThreadPoolTask*> deque;
+        std::atomic<std::uint64_t> executed{0};
+        std::atomic<std::uint64_t> stolen{0};
+        std::atomic<std::uint64_t> parks{0};
+        std::thread thread;
+    };
+
+    // Single writer: a relaxed load + store avoids a locked read-modify-write.
+    static void bump(std::atomic<std::uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void enqueue(ThreadPoolTask* task) {
+        const bool fromWorker = threadPoolCurrent == this;
+        // Counted before the accepting_ check so that shutdown()'s drain either waits for it or rejects it.
+        pending_.fetch_add(1, std::memory_order_seq_cst);
+        if (!fromWorker && !accepting_.load(std::memory_order_seq_cst)) {
+            delete task; // Its future reports broken_promise
+            finishTask();
+            return;
+        }
+        if (fromWorker) {
+            workers_[threadPoolWorkerIndex]->deque.push(task);
+        } else {
+            std::lock_guard<std::mutex> lock(injectMutex_);
+            injected_.push_back(task);
+            injectedCount_.store(injected_.size(), std::memory_order_relaxed);
+        }
+        wakeOne();
+    }
+
+    // Pairs with the increment in park(): either the parking worker's final scan finds the new task, or
+    // this sees the worker as a sleeper and wakes it.
+    void wakeOne() {
+#if THREADPOOL_TSAN
+        sleepers_.fetch_add(0, std::memory_order_seq_cst);
+#else
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+        if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex_);
+                events_.fetch_add(1, std::memory_order_relaxed);
+            }
+            sleepCv_.notify_one();
+        }
+    }
+
+    void finishTask() {
+        if (pending_.fetch_sub(1, std::memory_order_seq_cst) == 1 && idleWaiters_.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(idleMutex_);
+            idleCv_.notify_all();
+        }
+    }
+
+    ThreadPoolTask* takeInjected(Worker& self) {
+        if (injectedCount_.load(std::memory_order_relaxed) == 0) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(injectMutex_);
+        if (injected_.empty()) {
+            return nullptr;
+        }
+        ThreadPoolTask* task = injected_.front();
+        injected_.pop_front();
+        // Move a batch into the local deque where idle workers can steal it, newest first so that the
+        // owner's LIFO pops still start outside submissions in order.
+        const std::size_t batch = std::min(kThreadPoolInjectBatch - 1, injected_.size());
+        for (std::size_t i = batch; i > 0; --i) {
+            self.deque.push(injected_[i - 1]);
+        }
+        injected_.erase(injected_.begin(), injected_.begin() + static_cast<std::ptrdiff_t>(batch));
+        injectedCount_.store(injected_.size(), std::memory_order_relaxed);
+        return task;
+    }
+
+    ThreadPoolTask* findTask(std::size_t index, std::uint64_t& rng) {
+        Worker& self = *workers_[index];
+        if (ThreadPoolTask* task = self.deque.pop()) {
+            return task;
+        }
+        if (ThreadPoolTask* task = takeInjected(self)) {
+            return task;
+        }
+        const std::size_t count = workers_.size();
+        rng ^= rng << 13; // xorshift64: a random starting victim spreads thieves out
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        const std::size_t start = static_cast<std::size_t>(rng % count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t victim = (start + i) % count;
+            if (victim == index) {
+                continue;
+            }
+            if (ThreadPoolTask* task = workers_[victim]->deque.steal()) {
+                bump(self.stolen);
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    void execute(Worker& self, ThreadPoolTask* task) {
+        task->run(); // packaged_task stores exceptions in the future
+        delete task;
+        bump(self.executed);
+        finishTask();
+    }
+
+    // Returns false when the pool is stopping.
+    bool park(std::size_t index, std::uint64_t& rng) {
+        Worker& self = *workers_[index];
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        const std::uint64_t seen = events_.load(std::memory_order_acquire);
+        if (ThreadPoolTask* task = findTask(index, rng)) {
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            execute(self, task);
+            return true;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        bump(self.parks);
+        while (events_.load(std::memory_order_relaxed) == seen && !stopping_.load(std::memory_order_acquire)) {
+            sleepCv_.wait(lock);
+        }
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        return !stopping_.load(std::memory_order_acquire);
+    }
+
+    void workerLoop(std::size_t index) {
+        threadPoolCurrent = this;
+        threadPoolWorkerIndex = index;
+        Worker& self = *workers_[index];
+        std::uint64_t rng = 0x9E3779B97F4A7C15ull * (index + 1);
+        for (;;) {
+            ThreadPoolTask* task = findTask(index, rng);
+            for (int spin = 0; task == nullptr && spin < kThreadPoolSpinRounds; ++spin) {
+                std::this_thread::yield();
+                task = findTask(index, rng);
+            }
+            if (task != nullptr) {
+                execute(self, task);
+            } else if (!park(index, rng)) {
+                return; // shutdown() drained the pool before stopping it
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex injectMutex_;
+    std::deque<ThreadPoolTask*> injected_;
+    std::atomic<std::size_t> injectedCount_{0};
+    std::atomic<std::size_t> pending_{0}; // Submitted and not yet finished
+    std::atomic<int> sleepers_{0};
+    std::atomic<std::uint64_t> events_{0}; // Bumped under sleepMutex_ to wake parked workers
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCv_;
+    std::atomic<int> idleWaiters_{0};
+    std::mutex idleMutex_;
+    std::condition_variable idleCv_;
+    std::atomic<bool> accepting_{true};
+    std::atomic<bool> stopping_{false};
+    std::mutex shutdownMutex_;
+};
+
+// Process-wide pool used by the threading demos; one worker per hardware thread.
+ThreadPool& sharedThreadPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+//------------------------------------------------------------------------------
+// Section 3: Benchmarks - Dispatch Latency and Fine-Grained Scaling
+//------------------------------------------------------------------------------
+
+// The work of one split-sum task. Out of line so the tasks and the plain-loop baseline run the same code.
+__attribute__((noinline)) std::uint64_t splitSumRange(const std::uint64_t* data, std::size_t begin, std::size_t end) {
+    std::uint64_t sum = 0;
+    for (std::size_t i = begin; i < end; ++i) {
+        sum += data[i] * data[i] ^ (data[i] >> 3);
+    }
+    return sum;
+}
+
+/*
+ * Function: spawnSplitSum()
+ *
+ * Purpose: Fork-only divide and conquer: split [begin, end) in halves, submitting one half as a new task
+ *          (onto the worker's own deque, where idle workers steal it) and continuing with the other.
+ *          Leaves add their sum to `total`; completion is observed with wait_idle().
+ */
+void spawnSplitSum(ThreadPool& pool, const std::vector<std::uint64_t>& data, std::size_t begin, std::size_t end,
+                   std::size_t grain, std::atomic<std::uint64_t>& total) {
+    while (end - begin > grain) {
+        const std::size_t mid = begin + (end - begin) / 2;
+        pool.submit([&pool, &data, mid, end, grain, &total] { spawnSplitSum(pool, data, mid, end, grain, total); });
+        end = mid;
+    }
+    total.fetch_add(splitSumRange(data.data(), begin, end), std::memory_order_relaxed);
+}
+
+// Plain loop over the same grain-sized ranges the tasks get; seconds, best of three runs.
+double sequentialSplitSum(const std::vector<std::uint64_t>& data, std::size_t grain, std::uint64_t& sum) {
+    double best = 0;
+    for (int run = 0; run < 3; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        sum = 0;
+        for (std::size_t begin = 0; begin < data.size(); begin += grain) {
+            sum += splitSumRange(data.data(), begin, std::min(begin + grain, data.size()));
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best = run == 0 ? seconds : std::min(best, seconds);
+    }
+    return best;
+}
+
+void benchmarkThreadPool() {
+    using Clock = std::chrono::steady_clock;
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+
+    // Round trip: submit a trivial task from outside and wait for its future.
+    ThreadPool& pool = sharedThreadPool();
+    const int roundTrips = 20000;
+    auto start = Clock::now();
+    for (int i = 0; i < roundTrips; ++i) {
+        pool.submit([i] { return i; }).get();
+    }
+    const double poolRoundTripNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / roundTrips;
+
+    const int spawns = 2000;
+    start = Clock::now();
+    for (int i = 0; i < spawns; ++i) {
+        std::thread([] {}).join();
+    }
+    const double spawnNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / spawns;
+    std::cout << "Submit + future.get() round trip: " << poolRoundTripNs / 1000.0 << " us; std::thread spawn + join: "
+              << spawnNs / 1000.0 << " us\n";
+
+    // Per-task cost inside the pool: many small tasks spawned by tasks, against a plain loop.
+    std::vector<std::uint64_t> data(1 << 22);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = i * 0x9E3779B97F4A7C15ull;
+    }
+
+    std::vector<unsigned> workerCounts;
+    for (unsigned w = 1; w < hardware; w *= 2) {
+        workerCounts.push_back(w);
+    }
+    workerCounts.push_back(hardware);
+
+    std::cout << "Fine-grained split sum over " << data.size() << " elements:\n";
+    for (std::size_t grain : {std::size_t(256), std::size_t(4096)}) {
+        std::uint64_t expected = 0;
+        const double sequential = sequentialSplitSum(data, grain, expected);
+        std::cout << "  grain " << grain << ", plain loop over the same ranges: " << sequential * 1e3 << " ms\n";
+        for (unsigned workers : workerCounts) {
+            ThreadPool local(workers);
+            std::atomic<std::uint64_t> total{0};
+            start = Clock::now();
+            local.submit([&] { spawnSplitSum(local, data, 0, data.size(), grain, total); });
+            local.wait_idle();
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            const std::size_t tasks = data.size() / grain;
+            // Worker time beyond the plain loop, per task; timer noise can push it below zero, so clamp.
+            const double overheadNs = std::max(0.0, seconds * workers - sequential) * 1e9 / tasks;
+            std::cout << "  grain " << grain << ", " << workers << " worker(s): " << seconds * 1e3 << " ms ("
+                      << sequential / seconds << "x), overhead " << overheadNs << " ns/task, "
+                      << local.stats().stolen << " steals"
+                      << (total.load() == expected ? "" : " (wrong sum)") << "\n";
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Section 4: Demonstration
+//------------------------------------------------------------------------------
+
+void runThreadPoolExamples() {
+    std::cout << "\n--- Work-Stealing Thread Pool ---\n";
+    ThreadPool& pool = sharedThreadPool();
+    std::cout << "Shared pool workers: " << pool.size() << "\n";
+
+    std::future<int> answer = pool.submit([](int a, int b) { return a * b; }, 6, 7);
+    std::future<void> failing = pool.submit([] { throw std::runtime_error("task failed"); });
+    std::cout << "6 * 7 = " << answer.get() << "\n";
+    try {
+        failing.get();
+    } catch (const std::exception& e) {
+        std::cout << "Exception carried by the future: " << e.what() << "\n";
+    }
+
+    benchmarkThreadPool();
+
+    ThreadPool closing(2);
+    closing.shutdown();
+    try {
+        closing.submit([] {}).get();
+    } catch (const std::future_error& e) {
+        std::cout << "submit() after shutdown(): " << e.code().message() << "\n";
+    }
+}
+
+#endif // THREADPOOL_H
@@ -6,6 +6,8 @@
 #include <mutex>          // For mutual exclusion to synchronize access to shared resources
 #include <vector>         // For storing a dynamic collection of threads
 #include <chrono>         // For working with time durations (sleep)
+#include <future>         // For the futures returned by ThreadPool::submit()
+#include "ThreadPool.h"   // For sharedThreadPool(), reusable worker threads
 
 //------------------------------------------------------------------------------
 // Section 1: Threads in C++ (Concurrent Execution)
@@ -60,31 +62,34 @@ void basicThreadFunction(int n) {
 
 /*
  * Function: runThreadSupport()
- * Purpose: This function demonstrates the creation, management, and joining of threads in C++.
+ * Purpose: This function demonstrates running tasks concurrently and waiting for all of them.
+ *          Creating a std::thread per task pays thread creation and teardown every time, so the tasks
+ *          run on the reusable workers of sharedThreadPool() (ThreadPool.h) instead.
  */
 void runThreadSupport() {
     std::cout << "\n--- Threading Demonstration ---\n";
 
-    // 1. Create a vector to store thread objects:
-    std::vector<std::thread> threads; // Dynamically resizable array of std::thread objects
+    // 1. Create a vector to store the futures of the submitted tasks:
+    std::vector<std::future<void>> tasks; // One future per task, used to wait for (and rethrow from) it
 
-    // 2. Launch 5 threads:
+    // 2. Submit 5 tasks to the pool:
+    ThreadPool& pool = sharedThreadPool();
     for (int i = 1; i <= 5; ++i) {
-        // Each thread is created with:
+        // Each task is created with:
         // - The function 'basicThreadFunction' as the entry point for execution.
-        // - The loop counter 'i' as an argument to the function (to uniquely identify each thread).
-        threads.emplace_back(basicThreadFunction, i);
-        // Note: 'emplace_back' is an efficient way to construct an object in place within the vector
+        // - The loop counter 'i' as an argument to the function (to uniquely identify each task).
+        tasks.push_back(pool.submit(basicThreadFunction, i));
+        // Note: submit() only queues the task; an idle worker picks it up, no thread is created
     }
 
-    // 3. Join all threads:
-    // - The main thread will wait here until all the threads in the 'threads' vector have finished executing.
-    // - This is important to ensure that the program doesn't terminate before all threads complete their work.
-    for (auto& t : threads) {
-        t.join(); // Join each thread, blocks the main thread until the joined thread finishes
+    // 3. Wait for all tasks:
+    // - The main thread will wait here until every submitted task has finished executing.
+    // - This replaces join(): the workers themselves keep running, ready for the next tasks.
+    for (auto& task : tasks) {
+        task.get(); // Blocks until the task finishes (and rethrows if it threw)
     }
 
-    std::cout << "All threads completed.\n";
+    std::cout << "All tasks completed.\n";
 }
 
 #endif // THREADSUPPORT_H
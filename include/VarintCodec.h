@@ -0,0 +1,317 @@
+#ifndef VARINTCODEC_H
+#define VARINTCODEC_H
+
+#include <iostream>       // For standard input/output operations (cout)
+#include <vector>         // For encoded buffers in the benchmark
+#include <cstdint>        // For fixed-width integer types
+#include <cstring>        // For memcpy
+#include <chrono>         // For timing the benchmark
+#include <random>         // For generating benchmark input
+
+#include "CpuFeatures.h"  // For SSSE3 runtime dispatch
+
+//------------------------------------------------------------------------------
+// Section 1: Variable-Length Integers
+//------------------------------------------------------------------------------
+
+/*
+ * Why variable-length integers?
+ * - writeData in binaryReadWrite() always takes 4 bytes, even for the value 7.
+ * - Most ids, counters and deltas are small, so an encoding whose size grows with the magnitude of
+ *   the value stores them in 1-2 bytes instead of 4 or 8.
+ *
+ * ZigZag:
+ * - Maps signed to unsigned so that small magnitudes of either sign stay small:
+ *   0 -> 0, -1 -> 1, 1 -> 2, -2 -> 3, ...  (n << 1) ^ (n >> 31)
+ *
+ * LEB128 (a.k.a. varint, as in Protocol Buffers):
+ * - 7 payload bits per byte, the high bit says "more bytes follow". Simple and compact, but the length
+ *   of each value is only known after inspecting its bytes one by one, which serializes decoding.
+ *
+ * Stream VByte (Lemire et al.):
+ * - Same idea, but the lengths are moved into a separate control stream: one control byte describes
+ *   four 32-bit integers (2 bits each: 1-4 bytes). Data bytes carry no continuation bits.
+ * - A decoder reads one control byte, looks up a precomputed 16-byte shuffle mask, and a single
+ *   PSHUFB instruction (SSSE3) scatters the next 4-16 data bytes into four 32-bit lanes:
+ *   four integers per instruction with no per-byte branches.
+ *
+ * Layout produced by streamVByteEncode(): [ (count + 3) / 4 control bytes ][ data bytes ].
+ */
+
+std::uint32_t zigzagEncode32(std::int32_t n) {
+    return (static_cast<std::uint32_t>(n) << 1) ^ static_cast<std::uint32_t>(n >> 31);
+}
+
+std::int32_t zigzagDecode32(std::uint32_t n) {
+    return static_cast<std::int32_t>((n >> 1) ^ (0u - (n & 1u)));
+}
+
+std::uint64_t zigzagEncode64(std::int64_t n) {
+    return (static_cast<std::uint64_t>(n) << 1) ^ static_cast<std::uint64_t>(n >> 63);
+}
+
+std::int64_t zigzagDecode64(std::uint64_t n) {
+    return static_cast<std::int64_t>((n >> 1) ^ (0u - (n & 1u)));
+}
+
+//------------------------------------------------------------------------------
+// Section 2: LEB128 (Scalar Reference Codec)
+//------------------------------------------------------------------------------
+
+const std::size_t kMaxVarint64Bytes = 10;
+
+// Encode `value` at `dst` (room for kMaxVarint64Bytes required). Returns the number of bytes written.
+std::size_t encodeVarint(std::uint64_t value, unsigned char* dst) {
+    std::size_t n = 0;
+    while (value >= 0x80) {
+        dst[n++] = static_cast<unsigned char>(value | 0x80);
+        value >>= 7;
+    }
+    dst[n++] = static_cast<unsigned char>(value);
+    return n;
+}
+
+// Decode one varint from [src, end). Returns bytes consumed, or 0 if truncated or longer than 10 bytes.
+std::size_t decodeVarint(const unsigned char* src, const unsigned char* end, std::uint64_t& value) {
+    value = 0;
+    for (std::size_t i = 0; i < kMaxVarint64Bytes && src + i < end; ++i) {
+        value |= static_cast<std::uint64_t>(src[i] & 0x7F) << (7 * i);
+        if ((src[i] & 0x80) == 0) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// Bulk LEB128 encode of 32-bit values. Returns bytes written (room for 5 * count bytes required).
+std::size_t encodeVarints(const std::uint32_t* values, std::size_t count, unsigned char* dst) {
+    unsigned char* p = dst;
+    for (std::size_t i = 0; i < count; ++i) {
+        p += encodeVarint(values[i], p);
+    }
+    return static_cast<std::size_t>(p - dst);
+}
+
+// Bulk LEB128 decode. Returns bytes consumed, or 0 on malformed input.
+std::size_t decodeVarints(const unsigned char* src, std::size_t size, std::uint32_t* values, std::size_t count) {
+    const unsigned char* p = src;
+    const unsigned char* end = src + size;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint64_t v;
+        const std::size_t n = decodeVarint(p, end, v);
+        if (n == 0 || v > 0xFFFFFFFFu) return 0;
+        values[i] = static_cast<std::uint32_t>(v);
+        p += n;
+    }
+    return static_cast<std::size_t>(p - src);
+}
+
+//------------------------------------------------------------------------------
+// Section 3: Stream VByte (Scalar Encoder, Scalar + SSSE3 Decoders)
+//------------------------------------------------------------------------------
+
+std::size_t streamVByteMaxBytes(std::size_t count) {
+    return (count + 3) / 4 + 4 * count;
+}
+
+/*
+ * Function: streamVByteEncode()
+ *
+ * Purpose: Encode `count` values at `dst` (room for streamVByteMaxBytes(count) required).
+ * Returns: total bytes written (control + data).
+ */
+std::size_t streamVByteEncode(const std::uint32_t* values, std::size_t count, unsigned char* dst) {
+    unsigned char* control = dst;
+    unsigned char* data = dst + (count + 3) / 4;
+    std::memset(control, 0, (count + 3) / 4);
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint32_t v = values[i];
+        const unsigned code = v < (1u << 8) ? 0 : v < (1u << 16) ? 1 : v < (1u << 24) ? 2 : 3;
+        for (unsigned b = 0; b <= code; ++b) {
+            *data++ = static_cast<unsigned char>(v >> (8 * b));
+        }
+        control[i / 4] |= static_cast<unsigned char>(code << (2 * (i % 4)));
+    }
+    return static_cast<std::size_t>(data - dst);
+}
+
+// Data bytes described by one control byte (4..16).
+unsigned streamVByteGroupLength(unsigned char controlByte) {
+    return 4 + (controlByte & 3) + ((controlByte >> 2) & 3) + ((controlByte >> 4) & 3) + (controlByte >> 6);
+}
+
+/*
+ * Function: streamVByteDecodeScalar()
+ *
+ * Purpose: Reference decoder. Reads `count` values from an encoding of `size` bytes.
+ * Returns: bytes consumed, or 0 if the input is too short.
+ */
+std::size_t streamVByteDecodeScalar(const unsigned char* src, std::size_t size, std::uint32_t* values, std::size_t count) {
+    const std::size_t controlBytes = (count + 3) / 4;
+    if (size < controlBytes) return 0;
+    const unsigned char* control = src;
+    const unsigned char* data = src + controlBytes;
+    const unsigned char* end = src + size;
+    for (std::size_t i = 0; i < count; ++i) {
+        const unsigned length = ((control[i / 4] >> (2 * (i % 4))) & 3) + 1;
+        if (data + length > end) return 0;
+        std::uint32_t v = 0;
+        for (unsigned b = 0; b < length; ++b) {
+            v |= static_cast<std::uint32_t>(data[b]) << (8 * b);
+        }
+        values[i] = v;
+        data += length;
+    }
+    return static_cast<std::size_t>(data - src);
+}
+
+#if CPUFEATURES_X86
+/*
+ * Shuffle table for the SIMD decoder: for each control byte, a PSHUFB mask that moves the packed data
+ * bytes of four integers into four little-endian 32-bit lanes (0x80 = write a zero byte).
+ */
+struct StreamVByteShuffleTable {
+    unsigned char masks[256][16];
+
+    StreamVByteShuffleTable() {
+        for (unsigned c = 0; c < 256; ++c) {
+            unsigned char src = 0;
+            for (unsigned lane = 0; lane < 4; ++lane) {
+                const unsigned length = ((c >> (2 * lane)) & 3) + 1;
+                for (unsigned b = 0; b < 4; ++b) {
+                    masks[c][lane * 4 + b] = b < length ? src++ : 0x80;
+                }
+            }
+        }
+    }
+};
+
+const StreamVByteShuffleTable& streamVByteShuffleTable() {
+    static const StreamVByteShuffleTable table;
+    return table;
+}
+
+/*
+ * Function: streamVByteDecodeSsse3()
+ *
+ * Purpose: Decode four integers per step with one 16-byte load and one PSHUFB. The 16-byte load may
+ *          extend past the group's data, so the last groups (where fewer than 16 bytes remain) and any
+ *          partial group are finished by the scalar decoder.
+ */
+CPUFEATURES_TARGET("ssse3")
+std::size_t streamVByteDecodeSsse3(const unsigned char* src, std::size_t size, std::uint32_t* values, std::size_t count) {
+    const std::size_t controlBytes = (count + 3) / 4;
+    if (size < controlBytes) return 0;
+    const StreamVByteShuffleTable& table = streamVByteShuffleTable();
+    const unsigned char* control = src;
+    const unsigned char* data = src + controlBytes;
+    const unsigned char* end = src + size;
+
+    std::size_t group = 0;
+    const std::size_t fullGroups = count / 4;
+    for (; group < fullGroups && data + 16 <= end; ++group) {
+        const unsigned char c = control[group];
+        const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.masks[c]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values + 4 * group), _mm_shuffle_epi8(packed, mask));
+        data += streamVByteGroupLength(c);
+    }
+
+    // Tail: decode the remaining values with the scalar loop, continuing from the current position.
+    for (std::size_t i = 4 * group; i < count; ++i) {
+        const unsigned length = ((control[i / 4] >> (2 * (i % 4))) & 3) + 1;
+        if (data + length > end) return 0;
+        std::uint32_t v = 0;
+        for (unsigned b = 0; b < length; ++b) {
+            v |= static_cast<std::uint32_t>(data[b]) << (8 * b);
+        }
+        values[i] = v;
+        data += length;
+    }
+    return static_cast<std::size_t>(data - src);
+}
+#endif
+
+// Decode with the fastest path supported by this CPU.
+std::size_t streamVByteDecode(const unsigned char* src, std::size_t size, std::uint32_t* values, std::size_t count) {
+#if CPUFEATURES_X86
+    if (cpuHasSsse3()) {
+        return streamVByteDecodeSsse3(src, size, values, count);
+    }
+#endif
+    return streamVByteDecodeScalar(src, size, values, count);
+}
+
+//------------------------------------------------------------------------------
+// Section 4: Throughput Benchmark
+//------------------------------------------------------------------------------
+
+/*
+ * Function: benchmarkVarintCodecs()
+ *
+ * Purpose: Encode `count` small-biased zigzagged integers with LEB128 and Stream VByte and time each
+ *          decoder. GB/s is measured on the decoded 32-bit output.
+ */
+void benchmarkVarintCodecs(std::size_t count) {
+    using Clock = std::chrono::steady_clock;
+    std::cout << "\n--- Varint Codec Throughput (" << count << " integers) ---\n";
+
+    std::mt19937 gen(42);
+    std::geometric_distribution<int> smallMagnitude(0.02); // Mostly < 128, occasionally much larger
+    std::vector<std::uint32_t> input(count);
+    for (std::uint32_t& v : input) {
+        const int magnitude = smallMagnitude(gen) * ((gen() % 64 == 0) ? 1000 : 1);
+        v = zigzagEncode32((gen() & 1) ? magnitude : -magnitude);
+    }
+
+    std::vector<unsigned char> leb(5 * count);
+    std::vector<unsigned char> svb(streamVByteMaxBytes(count));
+    const std::size_t lebBytes = encodeVarints(input.data(), count, leb.data());
+    const std::size_t svbBytes = streamVByteEncode(input.data(), count, svb.data());
+    std::cout << "Encoded size: fixed " << 4 * count << " bytes, LEB128 " << lebBytes
+              << " bytes, Stream VByte " << svbBytes << " bytes\n";
+
+    std::vector<std::uint32_t> output(count);
+    auto measure = [&](const char* label, std::size_t (*decoder)(const unsigned char*, std::size_t, std::uint32_t*, std::size_t),
+                       const std::vector<unsigned char>& encoded, std::size_t encodedBytes) {
+        const int rounds = 5;
+        const auto start = Clock::now();
+        bool ok = true;
+        for (int r = 0; r < rounds; ++r) {
+            ok = decoder(encoded.data(), encodedBytes, output.data(), count) == encodedBytes && ok;
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count() / rounds;
+        ok = ok && output == input;
+        std::cout << label << ": " << count / seconds / 1e6 << " M ints/s, "
+                  << 4.0 * count / seconds / 1e9 << " GB/s" << (ok ? "" : " (MISMATCH)") << "\n";
+    };
+
+    measure("LEB128 scalar       ", decodeVarints, leb, lebBytes);
+    measure("Stream VByte scalar ", streamVByteDecodeScalar, svb, svbBytes);
+#if CPUFEATURES_X86
+    if (cpuHasSsse3()) {
+        measure("Stream VByte SSSE3  ", streamVByteDecodeSsse3, svb, svbBytes);
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Section 5: Demonstration
+//------------------------------------------------------------------------------
+
+void runVarintCodecExamples() {
+    std::cout << "\n--- Varint and ZigZag Encoding ---\n";
+
+    for (std::int32_t n : {0, -1, 1, -64, 300, 1234}) {
+        unsigned char bytes[kMaxVarint64Bytes];
+        const std::size_t length = encodeVarint(zigzagEncode32(n), bytes);
+        std::uint64_t decoded = 0;
+        decodeVarint(bytes, bytes + length, decoded);
+        std::cout << n << " -> zigzag " << zigzagEncode32(n) << " -> " << length << " byte(s) -> "
+                  << zigzagDecode32(static_cast<std::uint32_t>(decoded)) << "\n";
+    }
+
+    benchmarkVarintCodecs(4000000);
+}
+
+#endif // VARINTCODEC_H
@@ -12,27 +12,48 @@
 #include "InheritanceAndPolymorphism.h"
 #include "OperatorOverloading.h"
 #include "ThreadSupport.h"
+#include "ThreadPool.h"
 #include "RegexExamples.h"
 #include "AdditionalUtilities.h"
 
 #include "STLContainers.h"
 #include "IteratorsAndAlgorithms.h"
 #include "SmartPointersAndMemory.h"
+#include "SlotPool.h"
 
 
 #include "TemplatesAndGenerics.h"
 #include "ExceptionHandling.h"
 #include "ConcurrentProgramming.h"
 #include "ByteStreaming.h"
+#include "BinarySerialization.h"
+#include "RecordFile.h"
+#include "StreamingBinaryWriter.h"
+#include "ColumnarFormat.h"
+#include "VarintCodec.h"
+#include "ChecksummedFraming.h"
+#include "AsyncReadEngine.h"
+#include "RecordIndex.h"
+#include "WriteAheadLog.h"
 #include "CustomMemoryAllocators.h"
+#include "PoolAllocator.h"
+#include "Arena.h"
+#include "SlabAllocator.h"
+#include "HeapProfiler.h"
 #include "DynamicMemoryBasics.h"
 #include "MemoryManagementTechniques.h"
+#include "IntrusivePtr.h"
 
 #include "MultithreadingAndConcurrency.h"
+#include "MpmcQueue.h"
+#include "SpscRing.h"
+#include "BatchChannel.h"
+#include "EpochReclamation.h"
 //#include "NetworkProgramming.h"
 
 #include "DesignPatterns.h"
 #include "CodeOptimization.h"
+#include "HugePageAllocator.h"
 #include "CompilerOptimizations.h"
 
 #include "ModernCppFeatures.h"
@@ -49,22 +70,44 @@ extern void runClassesAndObjects();
 extern void runInheritanceAndPolymorphism();
 extern void runOperatorOverloading();
 extern void runThreadSupport();
+extern void runThreadPoolExamples();
 extern void runRegexExamples();
 extern void runAdditionalUtilities();
 extern void runSTLContainers();
 extern void runIteratorsAndAlgorithms();
 extern void runSmartPointersAndMemory();
+extern void runSlotPoolExamples();
 extern void runTemplatesAndGenerics();
 extern void runExceptionHandling();
 extern void runConcurrentProgramming();
 extern void runByteStreamingExamples();
+extern void runBinarySerializationExamples();
+extern void runRecordFileExamples();
+extern void runStreamingBinaryWriterExamples();
+extern void runColumnarFormatExamples();
+extern void runVarintCodecExamples();
+extern void runChecksummedFramingExamples();
+extern void runAsyncReadEngineExamples();
+extern void runRecordIndexExamples();
+extern void runWriteAheadLogExamples();
 extern void demoNewDelete();
+extern void runHeapProfilerExamples();
 extern void demoCustomAllocator();
+extern void runAllocationTelemetryExamples();
+extern void runPoolAllocatorExamples();
+extern void runArenaExamples();
+extern void runSlabAllocatorExamples();
 extern void demoSmartPointers();
+extern void runIntrusivePtrExamples();
 extern void runMultithreadingAndConcurrency();
+extern void runMpmcQueueExamples();
+extern void runSpscRingExamples();
+extern void runBatchChannelExamples();
+extern void runEpochReclamationExamples();
 extern void runNetworkProgramming();
 extern void runDesignPatterns();
 extern void runCodeOptimization();
+extern void runHugePageAllocatorExamples();
 extern void runCompilerOptimizations();
 extern void runModernCppFeatures();
 extern void runModernLibrariesFrameworks();
@@ -97,6 +140,8 @@ void runSelectedChapter(int choice) {
             printSpacer();
             runThreadSupport();
             printSpacer();
+            runThreadPoolExamples();
+            printSpacer();
             runRegexExamples();
             printSpacer();
             runAdditionalUtilities();
@@ -108,18 +153,50 @@ void runSelectedChapter(int choice) {
             printSpacer();
             runSmartPointersAndMemory();
             printSpacer();
+            runSlotPoolExamples();
+            printSpacer();
             break;
         case 4:
             runTemplatesAndGenerics();
             printSpacer();
             runByteStreamingExamples();
             printSpacer();
+            runBinarySerializationExamples();
+            printSpacer();
+            runRecordFileExamples();
+            printSpacer();
+            runStreamingBinaryWriterExamples();
+            printSpacer();
+            runColumnarFormatExamples();
+            printSpacer();
+            runVarintCodecExamples();
+            printSpacer();
+            runChecksummedFramingExamples();
+            printSpacer();
+            runAsyncReadEngineExamples();
+            printSpacer();
+            runRecordIndexExamples();
+            printSpacer();
+            runWriteAheadLogExamples();
+            printSpacer();
             demoNewDelete();
             printSpacer();
+            runHeapProfilerExamples();
+            printSpacer();
             demoCustomAllocator();
             printSpacer();
+            runAllocationTelemetryExamples();
+            printSpacer();
+            runPoolAllocatorExamples();
+            printSpacer();
+            runArenaExamples();
+            printSpacer();
+            runSlabAllocatorExamples();
+            printSpacer();
             demoSmartPointers();
             printSpacer();
+            runIntrusivePtrExamples();
+            printSpacer();
             runConcurrentProgramming();
             printSpacer();
             runExceptionHandling();
@@ -128,12 +205,21 @@ void runSelectedChapter(int choice) {
         case 5:
             runMultithreadingAndConcurrency();
             printSpacer();
+            runMpmcQueueExamples();
+            printSpacer();
+            runSpscRingExamples();
+            printSpacer();
+            runBatchChannelExamples();
+            printSpacer();
+            runEpochReclamationExamples();
+            printSpacer();
 //            runNetworkProgramming();
             printSpacer();
             break;
         case 6:
             runDesignPatterns();
             runCodeOptimization();
+            runHugePageAllocatorExamples();
             runCompilerOptimizations();
             break;
         case 7: